@@ -0,0 +1,160 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#ifndef RSYNTH__AIG_H
+#define RSYNTH__AIG_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace rsynth {
+
+//=================================================================================================
+// AigLit -- an edge of the graph: node index and complement bit, like SWORD::Lit
+
+
+class AigLit {
+    uint32_t x;
+ public:
+    AigLit() : x(~0u)                                                         { }   // (aig_Undef)
+    explicit AigLit(uint32_t node, bool sign = false) : x(node + node + (uint32_t)sign) { }
+
+    friend uint32_t toInt  (AigLit p);
+    friend AigLit   toAigLit(uint32_t i);
+    friend AigLit   operator ~(AigLit p);
+    friend bool     sign   (AigLit p);
+    friend uint32_t node   (AigLit p);
+    friend AigLit   unsign (AigLit p);
+    friend AigLit   operator ^(AigLit p, bool b);
+
+    bool operator == (AigLit p) const { return x == p.x; }
+    bool operator != (AigLit p) const { return x != p.x; }
+    bool operator <  (AigLit p) const { return x < p.x;  }
+};
+
+inline uint32_t toInt   (AigLit p)         { return p.x; }
+inline AigLit   toAigLit(uint32_t i)       { AigLit p; p.x = i; return p; }
+inline AigLit   operator ~(AigLit p)       { AigLit q; q.x = p.x ^ 1; return q; }
+inline bool     sign    (AigLit p)         { return p.x & 1; }
+inline uint32_t node    (AigLit p)         { return p.x >> 1; }
+inline AigLit   unsign  (AigLit p)         { AigLit q; q.x = p.x & ~1u; return q; }
+inline AigLit   operator ^(AigLit p, bool b) { AigLit q; q.x = p.x ^ (uint32_t)b; return q; }
+
+const AigLit aig_False(0, false);   // node 0 is the constant
+const AigLit aig_True (0, true );
+const AigLit aig_Undef;
+
+
+//=================================================================================================
+// Aig -- and-inverter graph with xor nodes
+
+
+/**
+ * bit-level graph of AND and XOR nodes with complemented edges.
+ *
+ * Nodes are structurally hashed and simplified on construction (constants,
+ * equal and complementary fanins, two-level AND absorption and XOR
+ * cancellation against a fanin's fanins). A node is always created after its
+ * fanins, so increasing node indices are a topological order. XOR nodes
+ * never have complemented fanins, the complement is moved to the output.
+ *
+ * Nodes are 12 bytes in one array and referenced by 32-bit index, the
+ * structural hash is an open addressing table of node indices.
+ */
+class Aig {
+public:
+  enum NodeType { CONST, INPUT, AND, XOR };
+
+  Aig();
+
+  /**
+   * adds a primary input, <code>name</code> is kept for symbol maps
+   */
+  AigLit addInput(const std::string& name = std::string());
+
+  AigLit addAnd(AigLit a, AigLit b);
+  AigLit addXor(AigLit a, AigLit b);
+  AigLit addOr (AigLit a, AigLit b) { return ~addAnd(~a, ~b); }
+  AigLit addIff(AigLit a, AigLit b) { return ~addXor(a, b); }
+
+  /**
+   * adds s ? t : e, built from AND nodes (or a XOR node if t == ~e)
+   */
+  AigLit addIte(AigLit s, AigLit t, AigLit e);
+
+  /**
+   * AND resp. OR over all literals, as a balanced tree
+   */
+  AigLit addAnd(const std::vector<AigLit>& lits);
+  AigLit addOr (const std::vector<AigLit>& lits);
+
+  /**
+   * XOR over all literals. XOR nodes among the operands are flattened, and
+   * operands occurring an even number of times cancel, so repeated cascade
+   * terms t ^ f ^ ... ^ f disappear even when other terms lie in between.
+   */
+  AigLit addXor(const std::vector<AigLit>& lits);
+
+  unsigned numNodes () const { return _nodes.size(); }
+  unsigned numInputs() const { return _inputs.size(); }
+  unsigned numAnds  () const { return _numAnds; }
+  unsigned numXors  () const { return _numXors; }
+
+  NodeType type  (uint32_t n) const { return (NodeType)_nodes[n].type; }
+  AigLit   fanin0(uint32_t n) const { return _nodes[n].fanin0; }
+  AigLit   fanin1(uint32_t n) const { return _nodes[n].fanin1; }
+
+  /**
+   * the input nodes in creation order, and their names
+   */
+  const std::vector<uint32_t>& inputs() const { return _inputs; }
+  const std::string& inputName(unsigned i) const { return _names[i]; }
+
+  /**
+   * position of input node <code>n</code> in inputs()
+   */
+  unsigned inputIndex(uint32_t n) const { return toInt(_nodes[n].fanin0); }
+
+  /**
+   * recognises the AND structure built by addIte.
+   *
+   * @return true if <code>n</code> is an AND node with n == s ? t : e
+   */
+  bool isMux(uint32_t n, AigLit& s, AigLit& t, AigLit& e) const;
+
+  /**
+   * evaluates the graph on 64 input patterns at once,
+   * <code>inputs[i]</code> holds the patterns of the i-th input
+   */
+  std::vector<uint64_t> simulate(const std::vector<uint64_t>& inputs) const;
+
+  /**
+   * value of a literal under the node values returned by simulate
+   */
+  static uint64_t value(const std::vector<uint64_t>& values, AigLit l) {
+    return sign(l) ? ~values[node(l)] : values[node(l)];
+  }
+
+private:
+  AigLit addNode(NodeType t, AigLit a, AigLit b);
+  bool   absorb (AigLit a, AigLit b, AigLit& r);
+  void   rehash (unsigned size);
+  static uint32_t hash(uint32_t t, AigLit a, AigLit b);
+
+  struct Node {
+    uint32_t type;
+    AigLit   fanin0;    // input index for INPUT nodes
+    AigLit   fanin1;
+  };
+
+  std::vector<Node>        _nodes;
+  std::vector<uint32_t>    _inputs;
+  std::vector<std::string> _names;
+  std::vector<uint32_t>    _table;    // open addressing strash of node indices
+  unsigned _numAnds;
+  unsigned _numXors;
+
+}; /* class Aig */
+
+} /* namespace rsynth */
+
+#endif /* RSYNTH__AIG_H */
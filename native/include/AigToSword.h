@@ -0,0 +1,58 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#ifndef RSYNTH__AIGTOSWORD_H
+#define RSYNTH__AIGTOSWORD_H
+
+#include "Aig.h"
+#include "Word.h"
+
+#include <vector>
+
+namespace SWORD {
+class sword;
+class Signal;
+}
+
+namespace rsynth {
+
+/**
+ * lowers AIG literals into one-bit sword signals.
+ *
+ * Signals are created on demand for the cone of each requested literal,
+ * so only the part of the graph that is actually used reaches the solver.
+ * Inputs become one-bit variables named after the AIG input. The graph
+ * may grow between calls.
+ */
+class AigToSword {
+public:
+  AigToSword(const Aig& aig, SWORD::sword& solver);
+
+  SWORD::Signal* signal(AigLit l);
+
+  /**
+   * the bits of <code>w</code> concatenated into one signal, so that word
+   * level constructions can be combined with sword operators
+   */
+  SWORD::Signal* word(const Word& w);
+
+  /**
+   * value of the i-th input in the last model;
+   * false for inputs that were never lowered or are don't care
+   */
+  bool inputValue(unsigned i) const;
+
+  /**
+   * number of AIG nodes that have a signal
+   */
+  unsigned numLowered() const { return _numLowered; }
+
+private:
+  const Aig&     _aig;
+  SWORD::sword&  _solver;
+  std::vector<SWORD::Signal*> _signals;   // per node
+  std::vector<SWORD::Signal*> _negated;   // per node, NOT of _signals
+  unsigned _numLowered;
+}; /* class AigToSword */
+
+} /* namespace rsynth */
+
+#endif /* RSYNTH__AIGTOSWORD_H */
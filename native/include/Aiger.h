@@ -0,0 +1,38 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#ifndef RSYNTH__AIGER_H
+#define RSYNTH__AIGER_H
+
+#include "Aig.h"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace rsynth {
+
+/**
+ * writes the cones of <code>outputs</code> in binary AIGER format ("aig",
+ * combinational, no latches). XOR nodes are expanded into three ANDs. The
+ * symbol table holds the input names and <code>outputNames</code>, where
+ * given, so that inputs can be mapped back to signal bits.
+ *
+ * @return false on a stream error
+ */
+bool writeAiger(std::ostream& out, const Aig& aig, const std::vector<AigLit>& outputs,
+                const std::vector<std::string>& outputNames = std::vector<std::string>());
+
+/**
+ * reads a combinational AIGER file, binary or ASCII ("aag"), into
+ * <code>aig</code> (normally empty). Inputs are added in file order with
+ * their symbol names. AND triples forming a XOR, as written by writeAiger,
+ * become XOR nodes again. ASCII files must use the binary variable order
+ * (inputs, then ANDs), as produced by aigtoaig.
+ *
+ * @return false if the file is malformed or has latches
+ */
+bool readAiger(std::istream& in, Aig& aig, std::vector<AigLit>& outputs,
+               std::vector<std::string>* outputNames = 0);
+
+} /* namespace rsynth */
+
+#endif /* RSYNTH__AIGER_H */
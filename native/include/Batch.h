@@ -0,0 +1,43 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#ifndef RSYNTH__BATCH_H
+#define RSYNTH__BATCH_H
+
+#include <vector>
+
+namespace rsynth {
+
+struct BatchResult {
+  BatchResult() : found(false) { }
+
+  bool found;
+  std::vector<unsigned> circuit;   // indices into allGates(width), first gate first
+};
+
+/**
+ * synthesis of many targets of one width with a few encodings.
+ *
+ * Each of <code>threads</code> workers builds one encoding when it takes its
+ * first target and answers all further targets with the same sword
+ * instance, the target only being assumed, so the cascade is encoded once
+ * per worker instead of once per target and learnt clauses carry over from
+ * one target to the next. Workers take targets in turn; sword has no way to
+ * copy an instance, so the encodings are built side by side rather than
+ * cloned from one. Results are in the order of targets.
+ *
+ * solveBatch answers "length gates implement target" (CascadeEncoding).
+ */
+std::vector<BatchResult> solveBatch(unsigned width, unsigned length,
+                                    const std::vector<std::vector<unsigned> >& targets,
+                                    unsigned threads);
+
+/**
+ * a shortest cascade of at most maxLength gates for every target, as
+ * solveBatch with a SatSynthesizer per worker
+ */
+std::vector<BatchResult> synthesizeBatch(unsigned width, unsigned maxLength,
+                                         const std::vector<std::vector<unsigned> >& targets,
+                                         unsigned threads, bool lazy = false);
+
+} /* namespace rsynth */
+
+#endif /* RSYNTH__BATCH_H */
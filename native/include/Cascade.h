@@ -0,0 +1,110 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#ifndef RSYNTH__CASCADE_H
+#define RSYNTH__CASCADE_H
+
+#include "Aig.h"
+#include "AigToSword.h"
+
+#include <vector>
+
+namespace SWORD {
+class sword;
+class Signal;
+}
+
+namespace rsynth {
+
+/**
+ * the universal gate G(t, c1, c2): t' = t XOR (c1 OR NOT c2),
+ * <code>CustomGate</code> in reversible_synth/gates.py
+ */
+struct Gate { unsigned t, c1, c2; };
+
+/**
+ * all gates with distinct lines, in the order of
+ * <code>CustomGate.distinct_gates</code>
+ */
+std::vector<Gate> allGates(unsigned width);
+
+inline unsigned apply(const Gate& g, unsigned state) {
+  bool active = ((state >> g.c1) & 1) || !((state >> g.c2) & 1);
+  return active ? state ^ (1u << g.t) : state;
+}
+
+/**
+ * the truth table of a permutation of 2^width rows, one bit-vector per
+ * wire: bit r of <code>table[i]</code> (word r / 64) is bit i of
+ * <code>mapping[r]</code>
+ */
+std::vector<std::vector<uint64_t> > truthTable(unsigned width, const std::vector<unsigned>& mapping);
+
+/**
+ * the permutation of a cascade of gates (indices into gates), as
+ * <code>target[row]</code>
+ */
+std::vector<unsigned> simulate(unsigned width, const std::vector<Gate>& gates,
+                               const std::vector<unsigned>& circuit);
+
+/**
+ * the truth table of a cascade of gates, simulated on all rows at once, 64
+ * rows per word operation; truthTable(width, simulate(...)) but faster
+ */
+std::vector<std::vector<uint64_t> > simulateTable(unsigned width, const std::vector<Gate>& gates,
+                                                  const std::vector<unsigned>& circuit);
+
+/**
+ * <code>length</code> gates drawn uniformly from <code>numGates</code>,
+ * with the xorshift <code>state</code> (Random.h)
+ */
+std::vector<unsigned> randomCircuit(unsigned numGates, unsigned length, uint64_t& state);
+
+/**
+ * output bits of a gate cascade on the input <code>row</code>, where
+ * <code>sel[p][g]</code> selects gate g at position p
+ */
+std::vector<AigLit> addCascade(Aig& aig, unsigned width, const std::vector<Gate>& gates,
+                               const std::vector<std::vector<AigLit> >& sel, unsigned row);
+
+/**
+ * "<code>length</code> gates implement the permutation P" in a sword
+ * instance, with P left open.
+ *
+ * Exactly one gate is selected per position and the outputs of every
+ * truth-table row are lowered once in the constructor. solve() then only
+ * adds the target rows as assumptions, so one instance answers any number
+ * of targets of the same width and keeps what it learnt in between.
+ */
+class CascadeEncoding {
+public:
+  CascadeEncoding(SWORD::sword& solver, unsigned width, unsigned length);
+
+  unsigned width()  const { return _width; }
+  unsigned length() const { return _sel.size(); }
+  const std::vector<Gate>& gates() const { return _gates; }
+
+  /**
+   * @param target the permutation as <code>target[row]</code>, 2^width entries
+   * @return true if the cascade can implement target, see circuit()
+   */
+  bool solve(const std::vector<unsigned>& target);
+
+  /**
+   * the gates of the last satisfiable solve() as indices into gates(),
+   * first position first
+   */
+  std::vector<unsigned> circuit() const;
+
+private:
+  SWORD::sword&    _solver;
+  unsigned         _width;
+  std::vector<Gate> _gates;
+  Aig              _aig;
+  AigToSword       _lower;
+  std::vector<std::vector<AigLit> > _sel;          // per position and gate
+  std::vector<std::vector<AigLit> > _outputs;      // per row and wire
+  std::vector<std::vector<SWORD::Signal*> > _signals;  // of _outputs, unsigned
+}; /* class CascadeEncoding */
+
+} /* namespace rsynth */
+
+#endif /* RSYNTH__CASCADE_H */
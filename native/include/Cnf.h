@@ -0,0 +1,127 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#ifndef RSYNTH__CNF_H
+#define RSYNTH__CNF_H
+
+#include "Aig.h"
+
+#include <string>
+#include <vector>
+
+namespace SWORD {
+class sword;
+class Signal;
+}
+
+namespace rsynth {
+
+/**
+ * clause set in flat form.
+ *
+ * Literals are DIMACS integers (variable v > 0 as v or -v), all clauses
+ * are stored back to back in <code>lits</code>; clause i is
+ * [lits[starts[i]], lits[starts[i+1]]).
+ */
+struct Cnf {
+  Cnf() : numVars(0), starts(1, 0) { }
+
+  int newVar() { return ++numVars; }
+
+  void addClause(const int* first, const int* last) {
+    lits.insert(lits.end(), first, last);
+    starts.push_back(lits.size());
+  }
+  void addClause(int a)               { addClause(&a, &a + 1); }
+  void addClause(int a, int b)        { int c[] = { a, b };    addClause(c, c + 2); }
+  void addClause(int a, int b, int c) { int d[] = { a, b, c }; addClause(d, d + 3); }
+  void addClause(const std::vector<int>& c) { addClause(c.data(), c.data() + c.size()); }
+
+  unsigned numClauses() const { return starts.size() - 1; }
+  unsigned size(unsigned i) const { return starts[i+1] - starts[i]; }
+  const int* begin(unsigned i) const { return lits.data() + starts[i]; }
+  const int* end  (unsigned i) const { return lits.data() + starts[i+1]; }
+
+  int numVars;
+  std::vector<int>      lits;
+  std::vector<unsigned> starts;
+};
+
+
+/**
+ * translates the cone of asserted AIG literals into clauses.
+ *
+ * With <code>polarity</code> set, a node only gets the clauses for the
+ * polarities in which it is used (Plaisted-Greenbaum): an AND that is
+ * only required to be true gets (-n a) (-n b), but not (n -a -b). Without
+ * it every node gets both directions (Tseitin). With <code>muxes</code> set,
+ * the AND triples built by Aig::addIte are encoded as one ITE with the
+ * usual 2+2 clause template instead of three separate AND nodes.
+ *
+ * Encoding is incremental: asserting further literals only adds the
+ * clauses that are missing, including the other polarity of a node that
+ * was encoded one-sided before.
+ */
+class CnfEncoder {
+public:
+  CnfEncoder(const Aig& aig, bool polarity = true, bool muxes = true);
+
+  /**
+   * adds the unit clause (l) and the clauses of its cone
+   */
+  void assertLit(AigLit l);
+
+  /**
+   * @return a CNF literal that is equivalent to <code>l</code> in both
+   * directions, e.g. for assumptions or reading back a model
+   */
+  int defineLit(AigLit l);
+
+  /**
+   * the CNF variable of a node, 0 if the node has not been encoded
+   */
+  int var(uint32_t n) const { return n < _vars.size() ? _vars[n] : 0; }
+
+  /**
+   * the CNF variable of an input, allocated on demand so that models
+   * always cover all inputs
+   */
+  int inputVar(unsigned i);
+
+  /**
+   * variable names for writeDimacs and addCnf: the name (or "i<k>") of each
+   * input that has a variable, empty for internal nodes
+   */
+  std::vector<std::string> symbols() const;
+
+  const Cnf& cnf() const { return _cnf; }
+  Cnf& cnf() { return _cnf; }
+
+private:
+  enum { POS = 1, NEG = 2 };
+
+  int  lit(AigLit l);
+  void require(AigLit l, unsigned pol);
+  void encode(uint32_t n, unsigned pol);
+
+  const Aig& _aig;
+  bool _polarity;
+  bool _muxes;
+  Cnf  _cnf;
+  std::vector<int>      _vars;
+  std::vector<uint8_t>  _done;     // polarities already encoded, per node
+  std::vector<std::pair<AigLit, unsigned> > _stack;
+}; /* class CnfEncoder */
+
+
+/**
+ * asserts all clauses of <code>cnf</code> in a sword instance, one OR per
+ * clause over one-bit variables. Variables are named after
+ * <code>names</code> where given, "v&lt;i&gt;" otherwise.
+ *
+ * @return the signal of each CNF variable, index 0 is unused
+ */
+std::vector<SWORD::Signal*> addCnf(SWORD::sword& solver, const Cnf& cnf,
+                                   const std::vector<std::string>* names = 0);
+
+} /* namespace rsynth */
+
+#endif /* RSYNTH__CNF_H */
@@ -0,0 +1,33 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#ifndef RSYNTH__DIMACS_H
+#define RSYNTH__DIMACS_H
+
+#include "Cnf.h"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace rsynth {
+
+/**
+ * writes <code>cnf</code> in DIMACS format. Non-empty entries of
+ * <code>names</code> (indexed by variable) are written as "c v &lt;var&gt;
+ * &lt;name&gt;" comment lines ahead of the header, which other tools ignore.
+ *
+ * @return false on a stream error
+ */
+bool writeDimacs(std::ostream& out, const Cnf& cnf,
+                 const std::vector<std::string>& names = std::vector<std::string>());
+
+/**
+ * reads a DIMACS file into <code>cnf</code> (normally empty) and, if
+ * <code>names</code> is given, the "c v" symbol lines written by writeDimacs.
+ *
+ * @return false if the file is malformed
+ */
+bool readDimacs(std::istream& in, Cnf& cnf, std::vector<std::string>* names = 0);
+
+} /* namespace rsynth */
+
+#endif /* RSYNTH__DIMACS_H */
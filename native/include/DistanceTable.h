@@ -0,0 +1,73 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#ifndef RSYNTH__DISTANCETABLE_H
+#define RSYNTH__DISTANCETABLE_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <utility>
+#include <vector>
+
+namespace rsynth {
+
+/**
+ * optimal cascade lengths of all permutations within maxDepth gates of the
+ * identity, for widths up to 4: the BFS tables of
+ * scripts/precompute_bfs.py (written by its --distances option).
+ *
+ * A permutation is keyed by its images, 4 bits per row with row 0 in the
+ * lowest bits; keys are kept sorted and looked up by binary search.
+ */
+class DistanceTable {
+public:
+  DistanceTable() : _width(0), _maxDepth(0) { }
+
+  /**
+   * @param distances the optimal length per key, all keys within maxDepth
+   */
+  DistanceTable(unsigned width, unsigned maxDepth,
+                std::vector<std::pair<uint64_t, unsigned char> > distances);
+
+  unsigned width()    const { return _width; }
+  unsigned maxDepth() const { return _maxDepth; }
+  size_t   size()     const { return _keys.size(); }
+
+  static uint64_t key(const std::vector<unsigned>& target);
+
+  /**
+   * the optimal length of target if it is at most maxDepth, otherwise
+   * maxDepth + 1, which is then only a lower bound
+   */
+  unsigned lowerBound(const std::vector<unsigned>& target) const;
+
+  bool exact(const std::vector<unsigned>& target) const {
+    return lowerBound(target) <= _maxDepth;
+  }
+
+private:
+  friend bool readDistances(std::istream& in, DistanceTable& table);
+  friend bool writeDistances(std::ostream& out, const DistanceTable& table);
+
+  unsigned _width;
+  unsigned _maxDepth;
+  std::vector<uint64_t>      _keys;        // ascending
+  std::vector<unsigned char> _distances;   // per key
+}; /* class DistanceTable */
+
+/**
+ * reads the binary format of precompute_bfs.py --distances, little-endian:
+ *
+ *   "RSBFSD1\n", u32 width, u32 max depth, u64 count,
+ *   u64 key[count] (ascending), u8 distance[count]
+ *
+ * @return false if the file is malformed
+ */
+bool readDistances(std::istream& in, DistanceTable& table);
+
+/**
+ * @return false on a stream error
+ */
+bool writeDistances(std::ostream& out, const DistanceTable& table);
+
+} /* namespace rsynth */
+
+#endif /* RSYNTH__DISTANCETABLE_H */
@@ -0,0 +1,69 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#ifndef RSYNTH__EQUIVALENCECHECKER_H
+#define RSYNTH__EQUIVALENCECHECKER_H
+
+#include "Cascade.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace rsynth {
+
+struct EquivalenceStats {
+  EquivalenceStats() : checks(0), simulated(0), structural(0), swept(0), solved(0), nodes(0), merged(0) { }
+
+  unsigned checks;       // equivalent() calls
+  unsigned simulated;    // told apart by random simulation
+  unsigned structural;   // miter folded to false by structural hashing
+  unsigned swept;        // outputs merged by SAT sweeping
+  unsigned solved;       // sword solve() calls on the swept miter
+  unsigned nodes;        // AIG nodes of both cascades, last check
+  unsigned merged;       // nodes merged by the sweep, last check
+};
+
+/**
+ * equivalence of two gate cascades on up to 64 wires, where the 2^width
+ * truth table of <code>Circuit.to_permutation()</code> is out of reach.
+ *
+ * Both cascades are first simulated on <code>words</code> times 64 random
+ * inputs, bit-parallel, which separates most different pairs at once.
+ * Otherwise they are built as one-bit signals over the same width inputs
+ * in one AIG, so that identical gate sequences share their nodes, and the
+ * AIG is swept (Sweep.h): an obfuscated copy computes the same
+ * intermediate functions in a different way, and merging them bottom-up
+ * takes small local proofs where one miter over both cascades would need
+ * a deep one. The outputs are then XORed wire by wire and OR-reduced into
+ * a miter on the swept graph, which sword solves unless it folded to false.
+ */
+class EquivalenceChecker {
+public:
+  explicit EquivalenceChecker(unsigned width, unsigned words = 16);
+
+  unsigned width() const { return _width; }
+
+  /**
+   * @param counterexample receives, if they differ, an input (bit i is
+   *   wire i) on which a and b give different outputs
+   * @return true if a and b implement the same permutation
+   */
+  bool equivalent(const std::vector<Gate>& a, const std::vector<Gate>& b, uint64_t& counterexample);
+
+  const EquivalenceStats& stats() const { return _stats; }
+
+private:
+  bool simulateDifferent(const std::vector<Gate>& a, const std::vector<Gate>& b, uint64_t& counterexample);
+
+  unsigned _width;
+  unsigned _words;
+  uint64_t _seed;    // xorshift state, carried from check to check
+  EquivalenceStats _stats;
+}; /* class EquivalenceChecker */
+
+/**
+ * the output of a cascade on one input, on up to 64 wires
+ */
+uint64_t apply(const std::vector<Gate>& gates, uint64_t state);
+
+} /* namespace rsynth */
+
+#endif /* RSYNTH__EQUIVALENCECHECKER_H */
@@ -0,0 +1,81 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#ifndef RSYNTH__INSTANCEBATCH_H
+#define RSYNTH__INSTANCEBATCH_H
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace rsynth {
+
+/**
+ * one solver instance of a batch: a file, or the text of an SMT-LIB
+ * benchmark taken from a stream
+ */
+struct Instance {
+  std::string name;   // the file, or <stream>:<n> for a benchmark from a stream
+  std::string path;   // empty if the instance is text
+  std::string text;
+};
+
+/**
+ * loads and solves one instance in a sword object of its own and returns
+ *
+ *   <sat|unsat> <seconds> load=<s> solve=<s> cpu=<s> <sizes>
+ *
+ * or "error <seconds> <message>". SMT-LIB (.smt or text), DIMACS (.cnf)
+ * and AIGER (.aig, .aag; all outputs are asserted) are read. Exceptions
+ * thrown while loading or solving become error results, so one bad
+ * instance does not end a batch. libsword keeps its search counters to
+ * itself; cpu is the thread time spent on the instance.
+ */
+std::string solveInstance(const Instance& instance);
+
+/**
+ * cuts a stream of concatenated SMT-LIB benchmarks into the text of each
+ * top level "(benchmark ...)" as it is read, skipping comments, strings
+ * and <code>{ }</code> user values when matching parentheses. Only the
+ * benchmark being cut is held in memory.
+ */
+class BenchmarkStream {
+public:
+  explicit BenchmarkStream(std::istream& in) : _in(in), _line(1) { }
+
+  /**
+   * @return false at the end of the stream, or if anything but whitespace
+   * and comments is found between benchmarks or the last one is not
+   * closed; error() then tells where
+   */
+  bool next(std::string& benchmark);
+
+  const std::string& error() const { return _error; }
+
+private:
+  bool fail(const char* message);
+
+  std::istream& _in;
+  unsigned      _line;
+  std::string   _error;
+};
+
+/**
+ * solves the instances that next() hands out on <code>threads</code>
+ * threads and calls report(i, instance, result) for the i-th instance in
+ * the order next() returned them, as soon as all earlier ones are done.
+ * Workers call next() one at a time, so it may read a stream; the text of
+ * an instance is released once it is solved, report gets its name and
+ * path. report is called under a lock.
+ */
+void solveInstances(const std::function<bool(Instance&)>& next, unsigned threads,
+                    const std::function<void(size_t, const Instance&, const std::string&)>& report);
+
+/**
+ * as above, for instances known in advance
+ */
+void solveInstances(const std::vector<Instance>& instances, unsigned threads,
+                    const std::function<void(size_t, const Instance&, const std::string&)>& report);
+
+} /* namespace rsynth */
+
+#endif /* RSYNTH__INSTANCEBATCH_H */
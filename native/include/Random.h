@@ -0,0 +1,28 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#ifndef RSYNTH__RANDOM_H
+#define RSYNTH__RANDOM_H
+
+#include <stdint.h>
+
+namespace rsynth {
+
+/**
+ * one step of the xorshift64 generator; the state must not be 0
+ */
+inline uint64_t xorshift(uint64_t& s) {
+  s ^= s << 13;
+  s ^= s >> 7;
+  s ^= s << 17;
+  return s;
+}
+
+/**
+ * a nonzero xorshift state for a small seed such as a --seed option
+ */
+inline uint64_t xorshiftState(uint64_t seed) {
+  return (seed + 1) * 0x9e3779b97f4a7c15ull;
+}
+
+} /* namespace rsynth */
+
+#endif /* RSYNTH__RANDOM_H */
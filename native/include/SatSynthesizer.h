@@ -0,0 +1,159 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#ifndef RSYNTH__SATSYNTHESIZER_H
+#define RSYNTH__SATSYNTHESIZER_H
+
+#include "Aig.h"
+#include "AigToSword.h"
+#include "Cascade.h"
+
+#include <vector>
+
+namespace SWORD {
+class sword;
+class Signal;
+}
+
+namespace rsynth {
+
+class DistanceTable;
+
+struct SynthesisStats {
+  SynthesisStats() : calls(0), positions(0), rows(0), refinements(0), skipped(0) { }
+
+  unsigned calls;         // sword solve() calls
+  unsigned positions;     // gate positions encoded so far
+  unsigned rows;          // truth-table rows encoded so far
+  unsigned refinements;   // lazy mode: candidates refuted by simulation
+  unsigned skipped;       // lengths refuted by the distance table, no solve() call
+};
+
+/**
+ * exact synthesis of gate cascades with sword.
+ *
+ * Position p selects its gate with three one-hot words t[p], c1[p] and
+ * c2[p] (pairwise disjoint), so a row costs O(width) nodes per position
+ * instead of one node per gate. Every truth-table row is simulated through
+ * the positions as one-bit signals; the state of each row after every
+ * position is kept.
+ *
+ * Lengths are tried from a lower bound upwards. "k gates implement P" only
+ * assumes the row states after position k equal P, so raising k adds one
+ * position to the same instance and keeps everything learnt at smaller k,
+ * and later targets of the same width reuse the positions and the learnt
+ * clauses as well. The first satisfiable k is optimal.
+ *
+ * In lazy mode (setLazy) only a few rows are constrained at first: row 0
+ * and the rows with one bit set. A candidate cascade is simulated on all
+ * rows bit-parallel (simulate in Cascade.h), a few of the rows it gets
+ * wrong are encoded and assumed, and the same instance is solved again.
+ * Unsatisfiability of a subset of the rows already proves the length
+ * infeasible, and most rows follow from a few others, so the encoding
+ * stays a small fraction of the 2^width rows at widths 8-10. The rows
+ * found for one length are kept for the next.
+ *
+ * Symmetry breaking (setSymmetryBreaking) prunes cascades that are
+ * equivalent to a smaller one. Adjacent gates that commute (neither
+ * target is a control of the other) must be in increasing
+ * (t, c1, c2) order, which also rules out adjacent identical gates. For a
+ * target that is invariant under relabelling the wires by some sigma,
+ * the first gate must not be larger than its relabelling. Each cascade
+ * can be brought into this form without getting longer, so the shortest
+ * length is unchanged; solve() then only finds cascades without such
+ * redundancy, e.g. no 2-gate identity.
+ *
+ * With a distance table of the same width (setDistanceTable), lengths
+ * below the table's bound for the target are refuted without a solve()
+ * call. If the first j <= 3 gates leave at most maxDepth gates, the rest
+ * of a cascade has a known optimal length: all j-gate prefixes are looked
+ * up, the length is refuted if no prefix leaves a remainder short enough,
+ * and otherwise the first gate is restricted to those of the prefixes that
+ * do. The last gate is restricted in the same way by the suffixes.
+ */
+class SatSynthesizer {
+public:
+  SatSynthesizer(SWORD::sword& solver, unsigned width);
+
+  unsigned width() const { return _width; }
+
+  /**
+   * encode rows on demand (counterexample-guided), off by default
+   */
+  void setLazy(bool lazy) { _lazy = lazy; }
+
+  /**
+   * @param ordering order adjacent commuting gates, on by default
+   * @param wires break wire relabelling symmetries of the target, off by
+   *   default (looks at all relabellings up to width 6, swaps of two
+   *   wires above)
+   */
+  void setSymmetryBreaking(bool ordering, bool wires) {
+    _ordering = ordering;
+    _wires = wires;
+  }
+
+  /**
+   * optimal lengths of short cascades, not owned; ignored unless it has
+   * the width of the synthesizer, 0 (the default) to not use one
+   */
+  void setDistanceTable(const DistanceTable* table) { _table = table; }
+
+  /**
+   * gates in the order of allGates(width), which circuits index into
+   */
+  const std::vector<Gate>& gates() const { return _gates; }
+
+  /**
+   * a shortest cascade for target, at most maxLength gates
+   *
+   * @param target the permutation as <code>target[row]</code>, 2^width entries
+   * @param circuit receives the gates, first gate first
+   * @return false if no cascade of at most maxLength gates exists
+   */
+  bool synthesize(const std::vector<unsigned>& target, unsigned maxLength,
+                  std::vector<unsigned>& circuit);
+
+  /**
+   * "exactly length gates implement target", circuit as in synthesize()
+   */
+  bool solve(const std::vector<unsigned>& target, unsigned length,
+             std::vector<unsigned>& circuit);
+
+  /**
+   * number of wires whose output differs from the input for some row;
+   * each gate changes one wire, so no shorter cascade exists
+   */
+  static unsigned lowerBound(unsigned width, const std::vector<unsigned>& target);
+
+  const SynthesisStats& stats() const { return _stats; }
+
+private:
+  void addPosition();
+  void addRow(unsigned row);
+  void extendRow(unsigned row);
+  bool solveRows(const std::vector<unsigned>& target, unsigned length,
+                 std::vector<unsigned>& rows, std::vector<unsigned>& circuit);
+  std::vector<unsigned> initialRows() const;
+  void assumeSymmetries(const std::vector<unsigned>& target);
+  bool tableCuts(const std::vector<unsigned>& target, unsigned length, std::vector<AigLit>& cuts);
+  AigLit addGateIn(unsigned position, const std::vector<bool>& allowed);
+
+  SWORD::sword&     _solver;
+  unsigned          _width;
+  std::vector<Gate> _gates;
+  std::vector<unsigned> _gateIndex;           // by (t * width + c1) * width + c2
+  Aig               _aig;
+  AigToSword        _lower;
+  std::vector<std::vector<AigLit> > _t, _c1, _c2;   // per position and wire
+  std::vector<std::vector<std::vector<AigLit> > > _states;   // per row, length and wire
+  std::vector<unsigned> _encoded;             // rows with states, in order of encoding
+  AigLit            _ordered;                 // enables the ordering of commuting gates
+  bool              _lazy;
+  bool              _ordering;
+  bool              _wires;
+  const DistanceTable* _table;
+  SynthesisStats    _stats;
+}; /* class SatSynthesizer */
+
+} /* namespace rsynth */
+
+#endif /* RSYNTH__SATSYNTHESIZER_H */
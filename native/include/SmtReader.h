@@ -0,0 +1,70 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#ifndef RSYNTH__SMTREADER_H
+#define RSYNTH__SMTREADER_H
+
+#include <string>
+#include <unordered_map>
+
+namespace SWORD {
+class sword;
+class Signal;
+}
+
+namespace rsynth {
+
+/**
+ * SMT-LIB 1.2 (QF_BV) front end that builds sword signals while parsing.
+ *
+ * The input is tokenised in place, a file is memory mapped rather than
+ * read, and symbols are interned by pointing into the text, so tokens are
+ * not copied. Declared names are copied once, for the sword variable and
+ * for variable(), which is used after a mapped file is released. Terms are built bottom up on an explicit stack as soon as their
+ * closing parenthesis is read; deeply nested lets and formulas therefore
+ * need neither recursion nor a syntax tree. <code>:extrafuns</code> and
+ * <code>:extrapreds</code> become sword variables, and every
+ * <code>:assumption</code> and <code>:formula</code> is asserted.
+ *
+ * Uninterpreted functions with arguments and arrays are not supported.
+ */
+class SmtReader {
+public:
+  explicit SmtReader(SWORD::sword& solver);
+
+  /**
+   * @return false on a syntax or sort error, see error()
+   */
+  bool parseFile(const std::string& path);
+  bool parse(const char* first, const char* last);
+
+  const std::string& error() const { return _error; }
+
+  /**
+   * the value of <code>:status</code>, empty if not given
+   */
+  const std::string& status() const { return _status; }
+
+  unsigned numAssertions() const { return _numAssertions; }
+
+  /**
+   * a declared variable or predicate, NULL if there is none of that name
+   */
+  SWORD::Signal* variable(const std::string& name) const;
+
+private:
+  friend class SmtParser;
+
+  struct Variable {
+    SWORD::Signal* signal;
+    unsigned width;
+  };
+
+  SWORD::sword& _solver;
+  std::string   _error;
+  std::string   _status;
+  unsigned      _numAssertions;
+  std::unordered_map<std::string, Variable> _variables;
+}; /* class SmtReader */
+
+} /* namespace rsynth */
+
+#endif /* RSYNTH__SMTREADER_H */
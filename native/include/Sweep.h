@@ -0,0 +1,41 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#ifndef RSYNTH__SWEEP_H
+#define RSYNTH__SWEEP_H
+
+#include "Aig.h"
+
+#include <vector>
+
+namespace rsynth {
+
+struct SweepStats {
+  SweepStats() : checks(0), proved(0), disproved(0), merged(0) { }
+
+  unsigned checks;      // SAT calls
+  unsigned proved;      // equivalences proved by SAT
+  unsigned disproved;   // candidates refuted, each gives a new pattern
+  unsigned merged;      // nodes replaced by an earlier node (SAT or structural)
+};
+
+/**
+ * SAT sweeping (fraiging): merges functionally equivalent nodes.
+ *
+ * Candidate pairs come from random simulation, <code>words</code> times 64
+ * patterns; nodes with equal or complementary signatures are candidates.
+ * The graph is rebuilt in topological order and each candidate is proved
+ * with a small incremental sword call on the already swept cones, which
+ * shrink as merges accumulate. A refuted candidate yields a counterexample
+ * that is simulated and used to separate later candidates.
+ *
+ * Inputs keep their order and names. <code>map[n]</code> receives the
+ * literal of node n in the result; nodes that were merged away may leave
+ * unreferenced nodes behind in the result graph.
+ *
+ * @param maxChecks SAT calls per node before it is kept as is
+ */
+Aig sweep(const Aig& aig, std::vector<AigLit>& map, SweepStats* stats = 0,
+          unsigned words = 4, unsigned maxChecks = 4);
+
+} /* namespace rsynth */
+
+#endif /* RSYNTH__SWEEP_H */
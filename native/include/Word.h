@@ -0,0 +1,99 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#ifndef RSYNTH__WORD_H
+#define RSYNTH__WORD_H
+
+#include "Aig.h"
+
+#include <string>
+#include <vector>
+
+namespace rsynth {
+
+/**
+ * a bit-vector as AIG literals, least significant bit first
+ * (the order of sword::getVariableAssignment)
+ */
+typedef std::vector<AigLit> Word;
+
+/**
+ * adds <code>width</code> inputs named "name[i]"
+ */
+Word addWord(Aig& aig, unsigned width, const std::string& name);
+
+Word constWord(uint64_t value, unsigned width);
+
+/**
+ * bitwise s ? t : e, t and e must have the same width
+ */
+Word addIte(Aig& aig, AigLit s, const Word& t, const Word& e);
+
+/**
+ * s == t as one literal
+ */
+AigLit addEqual(Aig& aig, const Word& s, const Word& t);
+
+/**
+ * constant array read <code>table[index]</code> (a ROM lookup).
+ *
+ * Each result bit is a balanced multiplexer tree over the index bits,
+ * most significant first. Sub-tables with equal contents share one tree,
+ * across rows and across result bits, and constant sub-tables fold to a
+ * constant, so a permutation table only costs what its structure needs.
+ * Entries past the end of <code>table</code> read as 0.
+ */
+Word addSelect(Aig& aig, const Word& index, const std::vector<uint64_t>& table, unsigned width);
+
+/**
+ * one-hot decoder: line i is true iff index == i, for i < n.
+ *
+ * Built as the AND of two half-width decoders, so it takes about n + 2
+ * sqrt(n) nodes. Repeated decoders of the same index are found by the
+ * structural hash and add no nodes, i.e. all bit selects and updates on
+ * one index share one decoder.
+ */
+std::vector<AigLit> addDecoder(Aig& aig, const Word& index, unsigned n);
+
+/**
+ * s[idx], 0 if idx is out of range
+ */
+AigLit addBitSelect(Aig& aig, const Word& s, const Word& idx);
+
+/**
+ * s with bit idx replaced by v, unchanged if idx is out of range
+ */
+Word addBitUpdate(Aig& aig, const Word& s, const Word& idx, AigLit v);
+
+/**
+ * s with bit idx flipped if f holds, one XOR per bit; this is the state
+ * update of a gate whose target line is chosen by idx
+ */
+Word addBitFlip(Aig& aig, const Word& s, const Word& idx, AigLit f);
+
+/**
+ * number of true bits, as a binary word of ceil(log2(n+1)) bits.
+ *
+ * Bits of equal weight are reduced with full and half adders (a Wallace
+ * tree), which takes about 5n AND/XOR nodes.
+ */
+Word addPopCount(Aig& aig, const std::vector<AigLit>& bits);
+
+/**
+ * Hamming distance of a and b, i.e. the population count of a ^ b
+ */
+Word addHamming(Aig& aig, const Word& a, const Word& b);
+
+/**
+ * unary count (totalizer): out[k] is true iff more than k bits are true,
+ * for k < bound. Bounding the outputs keeps the totalizer at O(n bound)
+ * nodes, which is what cardinality constraints need.
+ */
+std::vector<AigLit> addUnaryCount(Aig& aig, const std::vector<AigLit>& bits, unsigned bound);
+
+/**
+ * at most k of the bits are true
+ */
+AigLit addAtMost(Aig& aig, const std::vector<AigLit>& bits, unsigned k);
+
+} /* namespace rsynth */
+
+#endif /* RSYNTH__WORD_H */
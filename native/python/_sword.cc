@@ -0,0 +1,525 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+//
+// reversible_synth._sword: Python binding for libsword (make -C native python).
+//
+//   s = _sword.Sword()
+//   x = s.variable(8, "x")
+//   s.assertion(s.operator(_sword.EQUAL, s.operator(_sword.MUL, x, x), s.constant(8, 49)))
+//   if s.solve():
+//       bits = memoryview(s.model(x))   # int32 per bit, LSB first: 1, 0 or -1
+//
+// solve() releases the GIL, so independent Sword objects can be solved from
+// a thread pool in parallel. While one thread is inside solve(), every
+// other call on the same object raises RuntimeError instead of racing the
+// solver. A Signal keeps its Sword alive; signals of different Sword
+// objects cannot be mixed. Models own a copy of the assignment and expose
+// it through the buffer protocol, so memoryview() and numpy.frombuffer()
+// read it in place.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "libsword.h"
+
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace {
+
+//=================================================================================================
+// Sword, Signal and Model objects
+
+
+struct SwordObject {
+  PyObject_HEAD
+  SWORD::sword* solver;
+  bool          solving;
+};
+
+struct SignalObject {
+  PyObject_HEAD
+  SWORD::Signal* signal;
+  SwordObject*   owner;   // strong reference
+};
+
+struct ModelObject {
+  PyObject_HEAD
+  std::vector<int>* bits;
+  Py_ssize_t        shape[1];
+  Py_ssize_t        strides[1];
+};
+
+PyTypeObject SwordType  = { PyVarObject_HEAD_INIT(NULL, 0) };
+PyTypeObject SignalType = { PyVarObject_HEAD_INIT(NULL, 0) };
+PyTypeObject ModelType  = { PyVarObject_HEAD_INIT(NULL, 0) };
+
+/**
+ * @return false with RuntimeError set if another thread is solving
+ */
+bool available(SwordObject* self) {
+  if (self->solving) {
+    PyErr_SetString(PyExc_RuntimeError, "Sword is busy in solve() on another thread");
+    return false;
+  }
+  return true;
+}
+
+/**
+ * the signal behind a Python object of this solver, NULL with an exception set otherwise
+ */
+SWORD::Signal* toSignal(SwordObject* self, PyObject* o) {
+  if (!PyObject_TypeCheck(o, &SignalType)) {
+    PyErr_Format(PyExc_TypeError, "expected Signal, got %s", Py_TYPE(o)->tp_name);
+    return 0;
+  }
+  SignalObject* s = (SignalObject*)o;
+  if (s->owner != self) {
+    PyErr_SetString(PyExc_ValueError, "Signal belongs to a different Sword");
+    return 0;
+  }
+  return s->signal;
+}
+
+PyObject* newSignal(SwordObject* self, SWORD::Signal* signal) {
+  if (!signal) {
+    PyErr_SetString(PyExc_RuntimeError, "sword did not create the signal");
+    return 0;
+  }
+  SignalObject* s = PyObject_New(SignalObject, &SignalType);
+  if (!s) return 0;
+  s->signal = signal;
+  s->owner = self;
+  Py_INCREF(self);
+  return (PyObject*)s;
+}
+
+/**
+ * turns a C++ exception from the solver into RuntimeError
+ */
+#define SWORD_TRY try {
+#define SWORD_CATCH                                                         \
+  } catch (std::exception& e) {                                             \
+    PyErr_SetString(PyExc_RuntimeError, e.what());                          \
+    return 0;                                                               \
+  } catch (...) {                                                           \
+    PyErr_SetString(PyExc_RuntimeError, "sword raised an unknown exception"); \
+    return 0;                                                               \
+  }
+
+
+//=================================================================================================
+// Sword
+
+
+PyObject* Sword_new(PyTypeObject* type, PyObject*, PyObject*) {
+  SwordObject* self = (SwordObject*)type->tp_alloc(type, 0);
+  if (!self) return 0;
+  try {
+    self->solver = new SWORD::sword();
+  } catch (...) {
+    Py_DECREF(self);
+    PyErr_SetString(PyExc_RuntimeError, "cannot create sword instance");
+    return 0;
+  }
+  self->solving = false;
+  return (PyObject*)self;
+}
+
+void Sword_dealloc(SwordObject* self) {
+  delete self->solver;
+  Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+PyObject* Sword_variable(SwordObject* self, PyObject* args) {
+  unsigned width;
+  const char* name;
+  if (!available(self) || !PyArg_ParseTuple(args, "Is", &width, &name)) return 0;
+  if (width == 0) {
+    PyErr_SetString(PyExc_ValueError, "width must be positive");
+    return 0;
+  }
+  SWORD_TRY
+    return newSignal(self, self->solver->addVariable(width, name));
+  SWORD_CATCH
+}
+
+PyObject* Sword_constant(SwordObject* self, PyObject* args) {
+  unsigned width;
+  PyObject* value;
+  if (!available(self) || !PyArg_ParseTuple(args, "IO!", &width, &PyLong_Type, &value)) return 0;
+  if (width == 0) {
+    PyErr_SetString(PyExc_ValueError, "width must be positive");
+    return 0;
+  }
+
+  // value modulo 2^width, so that negative numbers are two's complement
+  PyObject* one = PyLong_FromLong(1);
+  PyObject* shift = PyLong_FromUnsignedLong(width);
+  PyObject* modulus = one && shift ? PyNumber_Lshift(one, shift) : 0;
+  PyObject* masked = modulus ? PyNumber_Remainder(value, modulus) : 0;
+  Py_XDECREF(one);
+  Py_XDECREF(shift);
+  Py_XDECREF(modulus);
+  if (!masked) return 0;
+
+  PyObject* result = 0;
+  if (width <= 64) {
+    unsigned long long x = PyLong_AsUnsignedLongLong(masked);
+    try {
+      result = newSignal(self, self->solver->addConstant(width, (unsigned long)x));
+    } catch (...) {
+      PyErr_SetString(PyExc_RuntimeError, "sword rejected the constant");
+    }
+  } else {
+    // the decimal string overload of addConstant loses bits, binary does not
+    PyObject* binary = PyNumber_ToBase(masked, 2);
+    const char* text = binary ? PyUnicode_AsUTF8(binary) : 0;
+    if (text) {
+      std::string bits(text + 2);   // without "0b"
+      bits.insert(0, width - bits.size(), '0');
+      try {
+        result = newSignal(self, self->solver->addBinConstant(width, bits));
+      } catch (...) {
+        PyErr_SetString(PyExc_RuntimeError, "sword rejected the constant");
+      }
+    }
+    Py_XDECREF(binary);
+  }
+  Py_DECREF(masked);
+  return result;
+}
+
+struct Opcode { const char* name; SWORD::OPCODE op; };
+
+// DISTINCT is left out, the bundled bit-blaster does not implement it
+const Opcode OPCODES[] = {
+  { "EQUAL", SWORD::EQUAL },     { "NEQUAL", SWORD::NEQUAL },
+  { "IMPLIES", SWORD::IMPLIES }, { "SLT", SWORD::SLT },         { "SLE", SWORD::SLE },
+  { "ULT", SWORD::ULT },         { "ULE", SWORD::ULE },         { "SGT", SWORD::SGT },
+  { "SGE", SWORD::SGE },         { "UGT", SWORD::UGT },         { "UGE", SWORD::UGE },
+  { "NOT", SWORD::NOT },         { "ITE", SWORD::ITE },         { "NEG", SWORD::NEG },
+  { "ADD", SWORD::ADD },         { "SUB", SWORD::SUB },         { "MUL", SWORD::MUL },
+  { "SDIV", SWORD::SDIV },       { "SREM", SWORD::SREM },       { "SMOD", SWORD::SMOD },
+  { "UDIV", SWORD::UDIV },       { "UREM", SWORD::UREM },       { "AND", SWORD::AND },
+  { "NAND", SWORD::NAND },       { "OR", SWORD::OR },           { "NOR", SWORD::NOR },
+  { "XOR", SWORD::XOR },         { "XNOR", SWORD::XNOR },       { "LSHL", SWORD::LSHL },
+  { "LSHR", SWORD::LSHR },       { "ASHR", SWORD::ASHR },       { "RED_OR", SWORD::RED_OR },
+  { "RED_AND", SWORD::RED_AND }, { "CONCAT", SWORD::CONCAT },
+};
+
+/**
+ * true for the opcodes exported as module constants; the others need
+ * parameters (EXTRACT, REPEAT, ...) or array sorts and have methods of
+ * their own or none
+ */
+bool exported(long op) {
+  for (unsigned i = 0; i < sizeof(OPCODES) / sizeof(OPCODES[0]); ++i)
+    if (OPCODES[i].op == op)
+      return true;
+  return false;
+}
+
+PyObject* Sword_operator(SwordObject* self, PyObject* args) {
+  Py_ssize_t n = PyTuple_GET_SIZE(args);
+  if (!available(self)) return 0;
+  if (n < 2) {
+    PyErr_SetString(PyExc_TypeError, "operator(op, a[, b[, c]]) or operator(op, [signals])");
+    return 0;
+  }
+  long op = PyLong_AsLong(PyTuple_GET_ITEM(args, 0));
+  if (op == -1 && PyErr_Occurred()) return 0;
+  if (!exported(op)) {
+    PyErr_Format(PyExc_ValueError, "invalid opcode %ld", op);
+    return 0;
+  }
+  SWORD::OPCODE o = (SWORD::OPCODE)op;
+
+  PyObject* first = PyTuple_GET_ITEM(args, 1);
+  if (n == 2 && PySequence_Check(first) && !PyObject_TypeCheck(first, &SignalType)) {
+    // vector form, e.g. an n-ary AND or OR
+    PyObject* seq = PySequence_Fast(first, "expected a sequence of signals");
+    if (!seq) return 0;
+    std::vector<SWORD::PSignal> inputs;
+    for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(seq); ++i) {
+      SWORD::Signal* s = toSignal(self, PySequence_Fast_GET_ITEM(seq, i));
+      if (!s) {
+        Py_DECREF(seq);
+        return 0;
+      }
+      inputs.push_back(s);
+    }
+    Py_DECREF(seq);
+    if (inputs.empty()) {
+      PyErr_SetString(PyExc_ValueError, "no input signals");
+      return 0;
+    }
+    SWORD_TRY
+      return newSignal(self, self->solver->addOperator(o, &inputs));
+    SWORD_CATCH
+  }
+
+  if (n > 4) {
+    PyErr_SetString(PyExc_TypeError, "at most three signals, pass a list for more");
+    return 0;
+  }
+  SWORD::PSignal in[3] = { 0, 0, 0 };
+  for (Py_ssize_t i = 1; i < n; ++i)
+    if (!(in[i - 1] = toSignal(self, PyTuple_GET_ITEM(args, i))))
+      return 0;
+  SWORD_TRY
+    return newSignal(self, self->solver->addOperator(o, in[0], in[1], in[2]));
+  SWORD_CATCH
+}
+
+PyObject* Sword_extract(SwordObject* self, PyObject* args) {
+  PyObject* o;
+  unsigned hi, lo;
+  if (!available(self) || !PyArg_ParseTuple(args, "OII", &o, &hi, &lo)) return 0;
+  SWORD::Signal* s = toSignal(self, o);
+  if (!s) return 0;
+  if (hi < lo) {
+    PyErr_SetString(PyExc_ValueError, "extract(s, hi, lo) needs hi >= lo");
+    return 0;
+  }
+  SWORD_TRY
+    return newSignal(self, self->solver->addExtract(s, hi, lo));
+  SWORD_CATCH
+}
+
+/**
+ * the (signal, count) operations: repeat, rotations and extensions
+ */
+template<SWORD::Signal* (*Op)(SWORD::sword&, SWORD::Signal*, unsigned)>
+PyObject* Sword_unary(SwordObject* self, PyObject* args) {
+  PyObject* o;
+  unsigned n;
+  if (!available(self) || !PyArg_ParseTuple(args, "OI", &o, &n)) return 0;
+  SWORD::Signal* s = toSignal(self, o);
+  if (!s) return 0;
+  SWORD_TRY
+    return newSignal(self, Op(*self->solver, s, n));
+  SWORD_CATCH
+}
+
+SWORD::Signal* repeat(SWORD::sword& s, SWORD::Signal* a, unsigned n)      { return s.addRepeat(a, n); }
+SWORD::Signal* rotateLeft(SWORD::sword& s, SWORD::Signal* a, unsigned n)  { return s.addRotateLeft(a, n); }
+SWORD::Signal* rotateRight(SWORD::sword& s, SWORD::Signal* a, unsigned n) { return s.addRotateRight(a, n); }
+SWORD::Signal* zeroExtend(SWORD::sword& s, SWORD::Signal* a, unsigned n)  { return s.addZeroExtend(a, n); }
+SWORD::Signal* signExtend(SWORD::sword& s, SWORD::Signal* a, unsigned n)  { return s.addSignExtend(a, n); }
+
+template<bool Assumption>
+PyObject* Sword_assert(SwordObject* self, PyObject* args) {
+  PyObject* o;
+  int value = 1;
+  if (!available(self) || !PyArg_ParseTuple(args, "O|p", &o, &value)) return 0;
+  SWORD::Signal* s = toSignal(self, o);
+  if (!s) return 0;
+  SWORD_TRY
+    if (Assumption) self->solver->addAssumption(s, value);
+    else            self->solver->addAssertion(s, value);
+  SWORD_CATCH
+  Py_RETURN_NONE;
+}
+
+PyObject* Sword_solve(SwordObject* self, PyObject*) {
+  if (!available(self)) return 0;
+  self->solving = true;
+  bool sat = false, failed = false;
+  Py_BEGIN_ALLOW_THREADS
+  try {
+    sat = self->solver->solve();
+  } catch (...) {
+    failed = true;
+  }
+  Py_END_ALLOW_THREADS
+  self->solving = false;
+  if (failed) {
+    PyErr_SetString(PyExc_RuntimeError, "sword failed in solve()");
+    return 0;
+  }
+  return PyBool_FromLong(sat);
+}
+
+PyObject* Sword_model(SwordObject* self, PyObject* o) {
+  if (!available(self)) return 0;
+  SWORD::Signal* s = toSignal(self, o);
+  if (!s) return 0;
+  ModelObject* m = PyObject_New(ModelObject, &ModelType);
+  if (!m) return 0;
+  m->bits = 0;
+  try {
+    m->bits = new std::vector<int>(self->solver->getVariableAssignment(s));
+  } catch (...) {
+    Py_DECREF(m);
+    PyErr_SetString(PyExc_ValueError, "only variables and constants have a model");
+    return 0;
+  }
+  m->shape[0] = m->bits->size();
+  m->strides[0] = sizeof(int);
+  return (PyObject*)m;
+}
+
+PyObject* Sword_value(SwordObject* self, PyObject* o) {
+  if (!available(self)) return 0;
+  SWORD::Signal* s = toSignal(self, o);
+  if (!s) return 0;
+  std::vector<int> bits;
+  try {
+    bits = self->solver->getVariableAssignment(s);
+  } catch (...) {
+    PyErr_SetString(PyExc_ValueError, "only variables and constants have a model");
+    return 0;
+  }
+  // most significant bit first as a binary literal, don't cares read as 0
+  std::string text(bits.size() + 1, '0');
+  for (unsigned i = 0; i < bits.size(); ++i)
+    if (bits[i] == SWORD::SWORD_TRUE)
+      text[bits.size() - i] = '1';
+  return PyLong_FromString(text.c_str(), 0, 2);
+}
+
+PyMethodDef SwordMethods[] = {
+  { "variable",     (PyCFunction)Sword_variable, METH_VARARGS,
+    "variable(width, name) -> Signal" },
+  { "constant",     (PyCFunction)Sword_constant, METH_VARARGS,
+    "constant(width, value) -> Signal, value modulo 2**width" },
+  { "operator",     (PyCFunction)Sword_operator, METH_VARARGS,
+    "operator(op, a[, b[, c]]) or operator(op, [signals]) -> Signal" },
+  { "extract",      (PyCFunction)Sword_extract, METH_VARARGS,
+    "extract(s, hi, lo) -> Signal, bits hi down to lo inclusive" },
+  { "repeat",       (PyCFunction)Sword_unary<repeat>, METH_VARARGS,
+    "repeat(s, n) -> Signal" },
+  { "rotate_left",  (PyCFunction)Sword_unary<rotateLeft>, METH_VARARGS,
+    "rotate_left(s, n) -> Signal" },
+  { "rotate_right", (PyCFunction)Sword_unary<rotateRight>, METH_VARARGS,
+    "rotate_right(s, n) -> Signal" },
+  { "zero_extend",  (PyCFunction)Sword_unary<zeroExtend>, METH_VARARGS,
+    "zero_extend(s, n) -> Signal, n more bits" },
+  { "sign_extend",  (PyCFunction)Sword_unary<signExtend>, METH_VARARGS,
+    "sign_extend(s, n) -> Signal, n more bits" },
+  { "assertion",    (PyCFunction)Sword_assert<false>, METH_VARARGS,
+    "assertion(s, value=True): s must be value in every solve()" },
+  { "assumption",   (PyCFunction)Sword_assert<true>, METH_VARARGS,
+    "assumption(s, value=True): like assertion, for the next solve() only" },
+  { "solve",        (PyCFunction)Sword_solve, METH_NOARGS,
+    "solve() -> bool, releases the GIL" },
+  { "model",        (PyCFunction)Sword_model, METH_O,
+    "model(s) -> Model, the bits of variable s in the last model" },
+  { "value",        (PyCFunction)Sword_value, METH_O,
+    "value(s) -> int, variable s in the last model, don't care bits read as 0" },
+  { 0, 0, 0, 0 }
+};
+
+
+//=================================================================================================
+// Signal
+
+
+void Signal_dealloc(SignalObject* self) {
+  SwordObject* owner = self->owner;
+  PyObject_Del(self);
+  Py_DECREF(owner);
+}
+
+
+//=================================================================================================
+// Model
+
+
+void Model_dealloc(ModelObject* self) {
+  delete self->bits;
+  PyObject_Del(self);
+}
+
+int Model_getbuffer(ModelObject* self, Py_buffer* view, int flags) {
+  if (flags & PyBUF_WRITABLE) {
+    PyErr_SetString(PyExc_BufferError, "Model is read-only");
+    view->obj = 0;
+    return -1;
+  }
+  view->obj = (PyObject*)self;
+  Py_INCREF(self);
+  view->buf = self->bits->empty() ? 0 : &(*self->bits)[0];
+  view->len = self->bits->size() * sizeof(int);
+  view->readonly = 1;
+  view->itemsize = sizeof(int);
+  view->format = (flags & PyBUF_FORMAT) ? (char*)"i" : 0;
+  view->ndim = 1;
+  view->shape = (flags & PyBUF_ND) ? self->shape : 0;
+  view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? self->strides : 0;
+  view->suboffsets = 0;
+  view->internal = 0;
+  return 0;
+}
+
+Py_ssize_t Model_length(ModelObject* self) {
+  return self->bits->size();
+}
+
+PyObject* Model_item(ModelObject* self, Py_ssize_t i) {
+  if (i < 0 || i >= (Py_ssize_t)self->bits->size()) {
+    PyErr_SetString(PyExc_IndexError, "Model index out of range");
+    return 0;
+  }
+  return PyLong_FromLong((*self->bits)[i]);
+}
+
+PyBufferProcs ModelBuffer = { (getbufferproc)Model_getbuffer, 0 };
+
+PySequenceMethods ModelSequence = {
+  (lenfunc)Model_length, 0, 0, (ssizeargfunc)Model_item,
+};
+
+
+//=================================================================================================
+// module
+
+
+PyModuleDef SwordModule = {
+  PyModuleDef_HEAD_INIT, "_sword", "Python binding for the SWORD bit-vector solver", -1,
+};
+
+} /* namespace */
+
+PyMODINIT_FUNC PyInit__sword() {
+  SwordType.tp_name = "reversible_synth._sword.Sword";
+  SwordType.tp_basicsize = sizeof(SwordObject);
+  SwordType.tp_flags = Py_TPFLAGS_DEFAULT;
+  SwordType.tp_doc = "one SWORD solver instance";
+  SwordType.tp_new = Sword_new;
+  SwordType.tp_dealloc = (destructor)Sword_dealloc;
+  SwordType.tp_methods = SwordMethods;
+
+  SignalType.tp_name = "reversible_synth._sword.Signal";
+  SignalType.tp_basicsize = sizeof(SignalObject);
+  SignalType.tp_flags = Py_TPFLAGS_DEFAULT;
+  SignalType.tp_doc = "a term of a Sword, created by its methods";
+  SignalType.tp_dealloc = (destructor)Signal_dealloc;
+
+  ModelType.tp_name = "reversible_synth._sword.Model";
+  ModelType.tp_basicsize = sizeof(ModelObject);
+  ModelType.tp_flags = Py_TPFLAGS_DEFAULT;
+  ModelType.tp_doc = "bit assignment of a signal, LSB first: 1, 0 or -1 (don't care)";
+  ModelType.tp_dealloc = (destructor)Model_dealloc;
+  ModelType.tp_as_buffer = &ModelBuffer;
+  ModelType.tp_as_sequence = &ModelSequence;
+
+  if (PyType_Ready(&SwordType) < 0 || PyType_Ready(&SignalType) < 0 || PyType_Ready(&ModelType) < 0)
+    return 0;
+
+  PyObject* m = PyModule_Create(&SwordModule);
+  if (!m) return 0;
+  Py_INCREF(&SwordType);
+  Py_INCREF(&SignalType);
+  Py_INCREF(&ModelType);
+  PyModule_AddObject(m, "Sword", (PyObject*)&SwordType);
+  PyModule_AddObject(m, "Signal", (PyObject*)&SignalType);
+  PyModule_AddObject(m, "Model", (PyObject*)&ModelType);
+  for (unsigned i = 0; i < sizeof(OPCODES) / sizeof(OPCODES[0]); ++i)
+    PyModule_AddIntConstant(m, OPCODES[i].name, OPCODES[i].op);
+  PyModule_AddIntConstant(m, "TRUE", SWORD::SWORD_TRUE);
+  PyModule_AddIntConstant(m, "FALSE", SWORD::SWORD_FALSE);
+  PyModule_AddIntConstant(m, "DONTCARE", SWORD::SWORD_DONTCARE);
+  return m;
+}
@@ -0,0 +1,234 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "Aig.h"
+
+#include <algorithm>
+#include <cassert>
+#include <unordered_map>
+
+namespace rsynth {
+
+Aig::Aig()
+  : _numAnds(0)
+  , _numXors(0)
+{
+  Node n = { CONST, aig_Undef, aig_Undef };
+  _nodes.push_back(n);
+}
+
+AigLit Aig::addInput(const std::string& name) {
+  Node n = { INPUT, toAigLit(_inputs.size()), aig_Undef };
+  _nodes.push_back(n);
+  _inputs.push_back(_nodes.size() - 1);
+  _names.push_back(name);
+  return AigLit(_nodes.size() - 1);
+}
+
+AigLit Aig::addAnd(AigLit a, AigLit b) {
+  if (b < a) std::swap(a, b);
+  // constants sort first
+  if (a == aig_False) return aig_False;
+  if (a == aig_True)  return b;
+  if (a == b)         return a;
+  if (a == ~b)        return aig_False;
+  AigLit r;
+  if (absorb(a, b, r) || absorb(b, a, r)) return r;
+  return addNode(AND, a, b);
+}
+
+bool Aig::absorb(AigLit a, AigLit b, AigLit& r) {
+  // two-level rules with a = (x & y) or a = ~(x & y)
+  if (type(node(a)) != AND) return false;
+  AigLit x = fanin0(node(a)), y = fanin1(node(a));
+  if (!sign(a)) {
+    // contradiction and idempotence
+    if (x == ~b || y == ~b) { r = aig_False; return true; }
+    if (x == b  || y == b)  { r = a;         return true; }
+    return false;
+  }
+  // absorption: b & (b | z) == b
+  if (x == ~b || y == ~b) { r = b; return true; }
+  // substitution: b & ~(b & z) == b & ~z
+  if (x == b) { r = addAnd(b, ~y); return true; }
+  if (y == b) { r = addAnd(b, ~x); return true; }
+  return false;
+}
+
+AigLit Aig::addXor(AigLit a, AigLit b) {
+  // complements are moved to the output
+  bool compl_ = sign(a) ^ sign(b);
+  a = unsign(a);
+  b = unsign(b);
+  if (b < a) std::swap(a, b);
+  if (a == aig_False) return b ^ compl_;
+  if (a == b)         return aig_False ^ compl_;
+  // cancellation: a ^ (a ^ z) == z
+  for (unsigned i = 0; i < 2; ++i) {
+    AigLit x = i ? b : a, y = i ? a : b;
+    if (type(node(x)) != XOR) continue;
+    if (fanin0(node(x)) == y) return fanin1(node(x)) ^ compl_;
+    if (fanin1(node(x)) == y) return fanin0(node(x)) ^ compl_;
+  }
+  return addNode(XOR, a, b) ^ compl_;
+}
+
+AigLit Aig::addXor(const std::vector<AigLit>& lits) {
+  // parity of every node reached through XOR nodes, fanouts first
+  std::vector<uint32_t> heap;
+  std::unordered_map<uint32_t, bool> parity;
+  bool compl_ = false;
+  for (unsigned i = 0; i < lits.size(); ++i) {
+    compl_ ^= sign(lits[i]);
+    uint32_t n = node(lits[i]);
+    if (!parity.count(n)) {
+      heap.push_back(n);
+      std::push_heap(heap.begin(), heap.end());
+    }
+    parity[n] = !parity[n];
+  }
+
+  std::vector<AigLit> leaves;
+  while (!heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end());
+    uint32_t n = heap.back();
+    heap.pop_back();
+    if (!parity[n] || n == 0)
+      continue;
+    if (type(n) != XOR) {
+      leaves.push_back(AigLit(n));
+      continue;
+    }
+    for (unsigned i = 0; i < 2; ++i) {
+      uint32_t m = node(i ? fanin1(n) : fanin0(n));
+      if (!parity.count(m)) {
+        heap.push_back(m);
+        std::push_heap(heap.begin(), heap.end());
+      }
+      parity[m] = !parity[m];
+    }
+  }
+
+  if (leaves.empty()) return aig_False ^ compl_;
+  // leaves come out in decreasing order, pair the deep ones first
+  std::reverse(leaves.begin(), leaves.end());
+  while (leaves.size() > 1) {
+    unsigned j = 0;
+    for (unsigned i = 0; i + 1 < leaves.size(); i += 2)
+      leaves[j++] = addXor(leaves[i], leaves[i+1]);
+    if (leaves.size() & 1)
+      leaves[j++] = leaves.back();
+    leaves.resize(j);
+  }
+  return leaves[0] ^ compl_;
+}
+
+AigLit Aig::addIte(AigLit s, AigLit t, AigLit e) {
+  if (s == aig_True)  return t;
+  if (s == aig_False) return e;
+  if (t == e)         return t;
+  if (t == ~e)        return addXor(s, e);
+  if (t == s || t == aig_True)   return addOr(s, e);
+  if (t == ~s || t == aig_False) return addAnd(~s, e);
+  if (e == ~s || e == aig_True)  return addOr(~s, t);
+  if (e == s || e == aig_False)  return addAnd(s, t);
+  return addOr(addAnd(s, t), addAnd(~s, e));
+}
+
+AigLit Aig::addAnd(const std::vector<AigLit>& lits) {
+  if (lits.empty()) return aig_True;
+  std::vector<AigLit> level(lits);
+  while (level.size() > 1) {
+    unsigned j = 0;
+    for (unsigned i = 0; i + 1 < level.size(); i += 2)
+      level[j++] = addAnd(level[i], level[i+1]);
+    if (level.size() & 1)
+      level[j++] = level.back();
+    level.resize(j);
+  }
+  return level[0];
+}
+
+AigLit Aig::addOr(const std::vector<AigLit>& lits) {
+  std::vector<AigLit> negated(lits.size());
+  for (unsigned i = 0; i < lits.size(); ++i)
+    negated[i] = ~lits[i];
+  return ~addAnd(negated);
+}
+
+uint32_t Aig::hash(uint32_t t, AigLit a, AigLit b) {
+  uint64_t k = ((uint64_t)toInt(a) << 32 | toInt(b)) * 0x9e3779b97f4a7c15ull;
+  return (uint32_t)(k >> 32) ^ (uint32_t)k ^ t;
+}
+
+AigLit Aig::addNode(NodeType t, AigLit a, AigLit b) {
+  assert(a < b);
+  if (2 * (_numAnds + _numXors + 1) > _table.size())
+    rehash(_table.empty() ? 1024 : 2 * _table.size());
+
+  // linear probing, slot 0 means empty since node 0 is never hashed
+  uint32_t mask = _table.size() - 1;
+  uint32_t i = hash(t, a, b) & mask;
+  for (; _table[i] != 0; i = (i + 1) & mask) {
+    const Node& n = _nodes[_table[i]];
+    if (n.type == (uint32_t)t && n.fanin0 == a && n.fanin1 == b)
+      return AigLit(_table[i]);
+  }
+
+  Node n = { (uint32_t)t, a, b };
+  _nodes.push_back(n);
+  uint32_t id = _nodes.size() - 1;
+  _table[i] = id;
+  if (t == AND) ++_numAnds; else ++_numXors;
+  return AigLit(id);
+}
+
+void Aig::rehash(unsigned size) {
+  std::vector<uint32_t> table(size, 0);
+  uint32_t mask = size - 1;
+  for (unsigned j = 0; j < _table.size(); ++j) {
+    if (_table[j] == 0) continue;
+    const Node& n = _nodes[_table[j]];
+    uint32_t i = hash(n.type, n.fanin0, n.fanin1) & mask;
+    while (table[i] != 0)
+      i = (i + 1) & mask;
+    table[i] = _table[j];
+  }
+  _table.swap(table);
+}
+
+bool Aig::isMux(uint32_t n, AigLit& s, AigLit& t, AigLit& e) const {
+  // n = ~(s & t) & ~(~s & e), i.e. ~n = s ? t : e
+  if (type(n) != AND) return false;
+  AigLit a = fanin0(n), b = fanin1(n);
+  if (!sign(a) || !sign(b)) return false;
+  if (type(node(a)) != AND || type(node(b)) != AND) return false;
+
+  AigLit a0 = fanin0(node(a)), a1 = fanin1(node(a));
+  AigLit b0 = fanin0(node(b)), b1 = fanin1(node(b));
+  if      (a0 == ~b0) { s = a0; t = a1; e = b1; }
+  else if (a0 == ~b1) { s = a0; t = a1; e = b0; }
+  else if (a1 == ~b0) { s = a1; t = a0; e = b1; }
+  else if (a1 == ~b1) { s = a1; t = a0; e = b0; }
+  else return false;
+
+  // n is the complement of the mux
+  t = ~t;
+  e = ~e;
+  return true;
+}
+
+std::vector<uint64_t> Aig::simulate(const std::vector<uint64_t>& inputs) const {
+  assert(inputs.size() == _inputs.size());
+  std::vector<uint64_t> values(_nodes.size(), 0);
+  for (unsigned i = 0; i < _inputs.size(); ++i)
+    values[_inputs[i]] = inputs[i];
+  for (uint32_t n = 1; n < _nodes.size(); ++n) {
+    switch (_nodes[n].type) {
+      case AND: values[n] = value(values, _nodes[n].fanin0) & value(values, _nodes[n].fanin1); break;
+      case XOR: values[n] = value(values, _nodes[n].fanin0) ^ value(values, _nodes[n].fanin1); break;
+      default: break;
+    }
+  }
+  return values;
+}
+
+} /* namespace rsynth */
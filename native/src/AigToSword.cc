@@ -0,0 +1,88 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "AigToSword.h"
+
+#include "libsword.h"
+
+#include <sstream>
+
+using namespace SWORD;
+
+namespace rsynth {
+
+AigToSword::AigToSword(const Aig& aig, sword& solver)
+  : _aig(aig)
+  , _solver(solver)
+  , _numLowered(0)
+{ }
+
+Signal* AigToSword::signal(AigLit root) {
+  if (_signals.size() < _aig.numNodes()) {
+    _signals.resize(_aig.numNodes(), PSignal());
+    _negated.resize(_aig.numNodes(), PSignal());
+  }
+
+  std::vector<uint32_t> stack(1, node(root));
+  while (!stack.empty()) {
+    uint32_t n = stack.back();
+    if (_signals[n]) {
+      stack.pop_back();
+      continue;
+    }
+    switch (_aig.type(n)) {
+      case Aig::CONST:
+        _signals[n] = _solver.addConstant(1, 0ul);
+        break;
+      case Aig::INPUT: {
+        unsigned i = _aig.inputIndex(n);
+        std::string name = _aig.inputName(i);
+        if (name.empty()) {
+          std::ostringstream s;
+          s << "i" << i;
+          name = s.str();
+        }
+        _signals[n] = _solver.addVariable(1, name);
+        break;
+      }
+      case Aig::AND: case Aig::XOR: {
+        uint32_t a = node(_aig.fanin0(n)), b = node(_aig.fanin1(n));
+        if (!_signals[a] || !_signals[b]) {
+          // fanins first
+          if (!_signals[a]) stack.push_back(a);
+          if (!_signals[b]) stack.push_back(b);
+          continue;
+        }
+        PSignal fa = _signals[a], fb = _signals[b];
+        if (sign(_aig.fanin0(n))) fa = _negated[a] ? _negated[a] : (_negated[a] = _solver.addOperator(NOT, fa));
+        if (sign(_aig.fanin1(n))) fb = _negated[b] ? _negated[b] : (_negated[b] = _solver.addOperator(NOT, fb));
+        _signals[n] = _solver.addOperator(_aig.type(n) == Aig::AND ? AND : XOR, fa, fb);
+        break;
+      }
+    }
+    ++_numLowered;
+    stack.pop_back();
+  }
+
+  uint32_t n = node(root);
+  if (!sign(root))
+    return _signals[n];
+  if (!_negated[n])
+    _negated[n] = _solver.addOperator(NOT, _signals[n]);
+  return _negated[n];
+}
+
+Signal* AigToSword::word(const Word& w) {
+  // CONCAT puts its first operand in the high bits
+  PSignal s = signal(w.back());
+  for (unsigned i = w.size() - 1; i-- > 0; )
+    s = _solver.addOperator(CONCAT, s, signal(w[i]));
+  return s;
+}
+
+bool AigToSword::inputValue(unsigned i) const {
+  uint32_t n = _aig.inputs()[i];
+  if (n >= _signals.size() || !_signals[n])
+    return false;
+  return _solver.getVariableAssignment(_signals[n])[0] == SWORD_TRUE;
+}
+
+} /* namespace rsynth */
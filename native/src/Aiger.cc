@@ -0,0 +1,210 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "Aiger.h"
+
+#include <istream>
+#include <ostream>
+#include <sstream>
+
+namespace rsynth {
+
+namespace {
+
+struct AndGate { uint32_t lhs, rhs0, rhs1; };
+
+void encode(std::ostream& out, uint32_t x) {
+  while (x & ~0x7fu) {
+    out.put((char)((x & 0x7f) | 0x80));
+    x >>= 7;
+  }
+  out.put((char)x);
+}
+
+bool decode(std::istream& in, uint32_t& x) {
+  x = 0;
+  for (unsigned shift = 0; shift < 32; shift += 7) {
+    int c = in.get();
+    if (c == EOF) return false;
+    x |= (uint32_t)(c & 0x7f) << shift;
+    if (!(c & 0x80)) return true;
+  }
+  return false;
+}
+
+/**
+ * AIGER writer state: node to literal map and the AND list in output order
+ */
+class Writer {
+public:
+  explicit Writer(const Aig& aig)
+    : _aig(aig), _lits(aig.numNodes(), 0), _next(aig.numInputs() + 1)
+  {
+    for (unsigned i = 0; i < aig.numInputs(); ++i)
+      _lits[aig.inputs()[i]] = 2 * (i + 1);
+  }
+
+  uint32_t lit(AigLit l) const { return _lits[node(l)] ^ (uint32_t)sign(l); }
+
+  void define(uint32_t n) {
+    uint32_t a = lit(_aig.fanin0(n)), b = lit(_aig.fanin1(n));
+    if (_aig.type(n) == Aig::AND) {
+      _lits[n] = addAnd(a, b);
+    } else {
+      // a ^ b == ~(a & ~b) & ~(~a & b), complemented
+      uint32_t p = addAnd(a, b ^ 1), q = addAnd(a ^ 1, b);
+      _lits[n] = addAnd(p ^ 1, q ^ 1) ^ 1;
+    }
+  }
+
+  uint32_t maxVar() const { return _next - 1; }
+  const std::vector<AndGate>& ands() const { return _ands; }
+
+private:
+  uint32_t addAnd(uint32_t a, uint32_t b) {
+    if (a < b) std::swap(a, b);
+    AndGate g = { 2 * _next++, a, b };
+    _ands.push_back(g);
+    return g.lhs;
+  }
+
+  const Aig& _aig;
+  std::vector<uint32_t> _lits;
+  std::vector<AndGate>  _ands;
+  uint32_t _next;
+};
+
+} /* namespace */
+
+bool writeAiger(std::ostream& out, const Aig& aig, const std::vector<AigLit>& outputs,
+                const std::vector<std::string>& outputNames) {
+  std::vector<bool> used(aig.numNodes(), false);
+  for (unsigned i = 0; i < outputs.size(); ++i)
+    used[node(outputs[i])] = true;
+  for (uint32_t n = aig.numNodes() - 1; n > 0; --n) {
+    if (!used[n] || (aig.type(n) != Aig::AND && aig.type(n) != Aig::XOR))
+      continue;
+    used[node(aig.fanin0(n))] = true;
+    used[node(aig.fanin1(n))] = true;
+  }
+
+  Writer w(aig);
+  for (uint32_t n = 1; n < aig.numNodes(); ++n)
+    if (used[n] && (aig.type(n) == Aig::AND || aig.type(n) == Aig::XOR))
+      w.define(n);
+
+  const std::vector<AndGate>& ands = w.ands();
+  out << "aig " << w.maxVar() << " " << aig.numInputs() << " 0 "
+      << outputs.size() << " " << ands.size() << "\n";
+  for (unsigned i = 0; i < outputs.size(); ++i)
+    out << w.lit(outputs[i]) << "\n";
+  for (unsigned i = 0; i < ands.size(); ++i) {
+    encode(out, ands[i].lhs - ands[i].rhs0);
+    encode(out, ands[i].rhs0 - ands[i].rhs1);
+  }
+  for (unsigned i = 0; i < aig.numInputs(); ++i)
+    if (!aig.inputName(i).empty())
+      out << "i" << i << " " << aig.inputName(i) << "\n";
+  for (unsigned i = 0; i < outputNames.size() && i < outputs.size(); ++i)
+    if (!outputNames[i].empty())
+      out << "o" << i << " " << outputNames[i] << "\n";
+  return out.good();
+}
+
+bool readAiger(std::istream& in, Aig& aig, std::vector<AigLit>& outputs,
+               std::vector<std::string>* outputNames) {
+  std::string format;
+  uint32_t M, I, L, O, A;
+  in >> format >> M >> I >> L >> O >> A;
+  if (!in || (format != "aig" && format != "aag") || L != 0 || M != I + A)
+    return false;
+  bool binary = format == "aig";
+
+  std::vector<uint32_t> outs(O);
+  std::vector<AndGate> ands(A);
+  for (uint32_t i = 0; !binary && i < I; ++i) {
+    uint32_t l;
+    if (!(in >> l) || l != 2 * (i + 1))
+      return false;
+  }
+  for (uint32_t i = 0; i < O; ++i)
+    if (!(in >> outs[i]) || outs[i] > 2 * M + 1)
+      return false;
+  if (binary)
+    in.ignore(1);   // newline after the last output
+  for (uint32_t j = 0; j < A; ++j) {
+    AndGate& g = ands[j];
+    g.lhs = 2 * (I + 1 + j);
+    if (binary) {
+      uint32_t d0, d1;
+      if (!decode(in, d0) || !decode(in, d1) || d0 == 0 || d0 > g.lhs || d1 > g.lhs - d0)
+        return false;
+      g.rhs0 = g.lhs - d0;
+      g.rhs1 = g.rhs0 - d1;
+    } else {
+      uint32_t lhs;
+      if (!(in >> lhs >> g.rhs0 >> g.rhs1) || lhs != g.lhs || g.rhs0 >= lhs || g.rhs1 >= lhs)
+        return false;
+    }
+  }
+
+  // symbol table, up to the comment section
+  std::vector<std::string> inputNames(I), names(O);
+  std::string line;
+  if (!binary)
+    std::getline(in, line);
+  while (std::getline(in, line) && !line.empty() && line[0] != 'c') {
+    std::istringstream s(line.substr(1));
+    uint32_t pos;
+    std::string name;
+    if (!(s >> pos) || !std::getline(s >> std::ws, name))
+      return false;
+    if (line[0] == 'i' && pos < I) inputNames[pos] = name;
+    else if (line[0] == 'o' && pos < O) names[pos] = name;
+    else return false;
+  }
+
+  // AND(~(p & q), ~(~p & ~q)) is p ^ q
+  std::vector<std::pair<uint32_t, uint32_t> > xors(A, std::make_pair(0u, 0u));
+  for (uint32_t j = 0; j < A; ++j) {
+    uint32_t a = ands[j].rhs0, b = ands[j].rhs1;
+    if (!(a & 1) || !(b & 1) || a / 2 <= I || b / 2 <= I)
+      continue;
+    const AndGate& ga = ands[a / 2 - I - 1];
+    const AndGate& gb = ands[b / 2 - I - 1];
+    if ((ga.rhs0 == (gb.rhs0 ^ 1) && ga.rhs1 == (gb.rhs1 ^ 1)) ||
+        (ga.rhs0 == (gb.rhs1 ^ 1) && ga.rhs1 == (gb.rhs0 ^ 1)))
+      xors[j] = std::make_pair(ga.rhs0, ga.rhs1);
+  }
+
+  // only the cones of the outputs, without the ANDs inside a XOR
+  std::vector<bool> used(M + 1, false);
+  for (uint32_t i = 0; i < O; ++i)
+    used[outs[i] / 2] = true;
+  for (uint32_t j = A; j-- > 0; ) {
+    if (!used[I + 1 + j]) continue;
+    bool isXor = xors[j].first != xors[j].second;
+    used[(isXor ? xors[j].first : ands[j].rhs0) / 2] = true;
+    used[(isXor ? xors[j].second : ands[j].rhs1) / 2] = true;
+  }
+
+  std::vector<AigLit> map(M + 1, aig_Undef);
+  map[0] = aig_False;
+  for (uint32_t i = 0; i < I; ++i)
+    map[i + 1] = aig.addInput(inputNames[i]);
+  for (uint32_t j = 0; j < A; ++j) {
+    if (!used[I + 1 + j]) continue;
+    bool isXor = xors[j].first != xors[j].second;
+    uint32_t a = isXor ? xors[j].first : ands[j].rhs0;
+    uint32_t b = isXor ? xors[j].second : ands[j].rhs1;
+    AigLit la = map[a / 2] ^ (bool)(a & 1), lb = map[b / 2] ^ (bool)(b & 1);
+    map[I + 1 + j] = isXor ? aig.addXor(la, lb) : aig.addAnd(la, lb);
+  }
+
+  outputs.clear();
+  for (uint32_t i = 0; i < O; ++i)
+    outputs.push_back(map[outs[i] / 2] ^ (bool)(outs[i] & 1));
+  if (outputNames)
+    *outputNames = names;
+  return true;
+}
+
+} /* namespace rsynth */
@@ -0,0 +1,92 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "Batch.h"
+#include "Cascade.h"
+#include "SatSynthesizer.h"
+
+#include "libsword.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+using namespace SWORD;
+
+namespace rsynth {
+
+namespace {
+
+/**
+ * runs threads workers over targets; a worker holds one Solver, built on
+ * its first target, and calls solver.solve(target, result) on each target
+ * it takes
+ */
+template <class Solver, class Make>
+std::vector<BatchResult> runBatch(const std::vector<std::vector<unsigned> >& targets,
+                                  unsigned threads, Make make) {
+  std::vector<BatchResult> results(targets.size());
+  std::atomic<size_t> next(0);
+  if (threads == 0) threads = 1;
+  if (threads > targets.size()) threads = targets.size();
+
+  std::vector<std::thread> pool;
+  for (unsigned t = 0; t < threads; ++t) {
+    pool.push_back(std::thread([&]() {
+      std::unique_ptr<Solver> solver;
+      for (size_t i; (i = next++) < targets.size(); ) {
+        if (!solver) solver.reset(make());
+        solver->solve(targets[i], results[i]);
+      }
+    }));
+  }
+  for (unsigned t = 0; t < pool.size(); ++t)
+    pool[t].join();
+  return results;
+}
+
+struct FixedLength {
+  FixedLength(unsigned width, unsigned length) : encoding(solver, width, length) { }
+
+  void solve(const std::vector<unsigned>& target, BatchResult& result) {
+    result.found = encoding.solve(target);
+    if (result.found)
+      result.circuit = encoding.circuit();
+  }
+
+  sword           solver;
+  CascadeEncoding encoding;
+};
+
+struct Shortest {
+  Shortest(unsigned width, unsigned maxLength, bool lazy)
+    : synth(solver, width)
+    , maxLength(maxLength)
+  {
+    synth.setLazy(lazy);
+  }
+
+  void solve(const std::vector<unsigned>& target, BatchResult& result) {
+    result.found = synth.synthesize(target, maxLength, result.circuit);
+  }
+
+  sword          solver;
+  SatSynthesizer synth;
+  unsigned       maxLength;
+};
+
+} /* namespace */
+
+std::vector<BatchResult> solveBatch(unsigned width, unsigned length,
+                                    const std::vector<std::vector<unsigned> >& targets,
+                                    unsigned threads) {
+  return runBatch<FixedLength>(targets, threads,
+      [=]() { return new FixedLength(width, length); });
+}
+
+std::vector<BatchResult> synthesizeBatch(unsigned width, unsigned maxLength,
+                                         const std::vector<std::vector<unsigned> >& targets,
+                                         unsigned threads, bool lazy) {
+  return runBatch<Shortest>(targets, threads,
+      [=]() { return new Shortest(width, maxLength, lazy); });
+}
+
+} /* namespace rsynth */
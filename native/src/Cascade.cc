@@ -0,0 +1,141 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "Cascade.h"
+#include "Random.h"
+#include "Word.h"
+
+#include "libsword.h"
+
+#include <cstdio>
+
+using namespace SWORD;
+
+namespace rsynth {
+
+std::vector<Gate> allGates(unsigned width) {
+  std::vector<Gate> gates;
+  for (unsigned t = 0; t < width; ++t)
+    for (unsigned c1 = 0; c1 < width; ++c1)
+      for (unsigned c2 = 0; c2 < width; ++c2)
+        if (t != c1 && t != c2 && c1 != c2) {
+          Gate g = { t, c1, c2 };
+          gates.push_back(g);
+        }
+  return gates;
+}
+
+std::vector<std::vector<uint64_t> > truthTable(unsigned width, const std::vector<unsigned>& mapping) {
+  std::vector<std::vector<uint64_t> > table(width, std::vector<uint64_t>((mapping.size() + 63) / 64, 0));
+  for (unsigned row = 0; row < mapping.size(); ++row)
+    for (unsigned i = 0; i < width; ++i)
+      if ((mapping[row] >> i) & 1)
+        table[i][row / 64] |= 1ull << (row % 64);
+  return table;
+}
+
+std::vector<unsigned> simulate(unsigned width, const std::vector<Gate>& gates,
+                               const std::vector<unsigned>& circuit) {
+  std::vector<unsigned> target(1u << width);
+  for (unsigned row = 0; row < target.size(); ++row) {
+    target[row] = row;
+    for (unsigned p = 0; p < circuit.size(); ++p)
+      target[row] = apply(gates[circuit[p]], target[row]);
+  }
+  return target;
+}
+
+std::vector<std::vector<uint64_t> > simulateTable(unsigned width, const std::vector<Gate>& gates,
+                                                  const std::vector<unsigned>& circuit) {
+  std::vector<unsigned> identity(1u << width);
+  for (unsigned row = 0; row < identity.size(); ++row)
+    identity[row] = row;
+  std::vector<std::vector<uint64_t> > table = truthTable(width, identity);
+  for (unsigned p = 0; p < circuit.size(); ++p) {
+    const Gate& g = gates[circuit[p]];
+    std::vector<uint64_t>& t = table[g.t];
+    const std::vector<uint64_t>& c1 = table[g.c1];
+    const std::vector<uint64_t>& c2 = table[g.c2];
+    for (unsigned j = 0; j < t.size(); ++j)
+      t[j] ^= c1[j] | ~c2[j];
+  }
+  // rows past 2^width in a partial last word are not part of the table
+  if (identity.size() % 64)
+    for (unsigned i = 0; i < width; ++i)
+      table[i].back() &= (1ull << (identity.size() % 64)) - 1;
+  return table;
+}
+
+std::vector<unsigned> randomCircuit(unsigned numGates, unsigned length, uint64_t& state) {
+  std::vector<unsigned> circuit(length);
+  for (unsigned p = 0; p < length; ++p)
+    circuit[p] = xorshift(state) % numGates;
+  return circuit;
+}
+
+std::vector<AigLit> addCascade(Aig& aig, unsigned width, const std::vector<Gate>& gates,
+                               const std::vector<std::vector<AigLit> >& sel, unsigned row) {
+  std::vector<AigLit> state(width);
+  for (unsigned w = 0; w < width; ++w)
+    state[w] = (row >> w) & 1 ? aig_True : aig_False;
+  for (unsigned p = 0; p < sel.size(); ++p) {
+    std::vector<std::vector<AigLit> > flips(width);
+    for (unsigned g = 0; g < gates.size(); ++g) {
+      AigLit active = aig.addOr(state[gates[g].c1], ~state[gates[g].c2]);
+      flips[gates[g].t].push_back(aig.addAnd(sel[p][g], active));
+    }
+    for (unsigned w = 0; w < width; ++w)
+      state[w] = aig.addXor(state[w], aig.addOr(flips[w]));
+  }
+  return state;
+}
+
+CascadeEncoding::CascadeEncoding(sword& solver, unsigned width, unsigned length)
+  : _solver(solver)
+  , _width(width)
+  , _gates(allGates(width))
+  , _lower(_aig, solver)
+  , _sel(length)
+{
+  for (unsigned p = 0; p < length; ++p) {
+    for (unsigned g = 0; g < _gates.size(); ++g) {
+      char name[64];
+      std::snprintf(name, sizeof(name), "sel_%u_%u", p, g);
+      _sel[p].push_back(_aig.addInput(name));
+    }
+    _solver.addAssertion(_lower.signal(_aig.addOr(_sel[p])));
+    _solver.addAssertion(_lower.signal(addAtMost(_aig, _sel[p], 1)));
+  }
+
+  for (unsigned row = 0; row < (1u << width); ++row) {
+    _outputs.push_back(addCascade(_aig, width, _gates, _sel, row));
+    _signals.push_back(std::vector<Signal*>(width, PSignal()));
+    for (unsigned w = 0; w < width; ++w)
+      if (node(_outputs[row][w]) != node(aig_False))
+        _signals[row][w] = _lower.signal(unsign(_outputs[row][w]));
+  }
+}
+
+bool CascadeEncoding::solve(const std::vector<unsigned>& target) {
+  // constant outputs (only without gates) are checked before any
+  // assumption is added, assumptions would otherwise leak into the next call
+  for (unsigned row = 0; row < _outputs.size(); ++row)
+    for (unsigned w = 0; w < _width; ++w)
+      if (!_signals[row][w] && ((target[row] >> w) & 1) != sign(_outputs[row][w]))
+        return false;
+
+  for (unsigned row = 0; row < _outputs.size(); ++row)
+    for (unsigned w = 0; w < _width; ++w)
+      if (_signals[row][w])
+        _solver.addAssumption(_signals[row][w], ((target[row] >> w) & 1) != sign(_outputs[row][w]));
+  return _solver.solve();
+}
+
+std::vector<unsigned> CascadeEncoding::circuit() const {
+  std::vector<unsigned> gates(_sel.size(), 0);
+  for (unsigned p = 0; p < _sel.size(); ++p)
+    for (unsigned g = 0; g < _gates.size(); ++g)
+      if (_lower.inputValue(p * _gates.size() + g))
+        gates[p] = g;
+  return gates;
+}
+
+} /* namespace rsynth */
@@ -0,0 +1,181 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "Cnf.h"
+
+#include "libsword.h"
+
+#include <cstdlib>
+#include <sstream>
+
+using namespace SWORD;
+
+namespace rsynth {
+
+CnfEncoder::CnfEncoder(const Aig& aig, bool polarity, bool muxes)
+  : _aig(aig)
+  , _polarity(polarity)
+  , _muxes(muxes)
+{ }
+
+void CnfEncoder::assertLit(AigLit l) {
+  if (l == aig_True) return;
+  if (l == aig_False) {
+    _cnf.addClause((const int*)0, (const int*)0);
+    return;
+  }
+  require(l, POS);
+  _cnf.addClause(lit(l));
+}
+
+int CnfEncoder::defineLit(AigLit l) {
+  require(l, POS | NEG);
+  return lit(l);
+}
+
+int CnfEncoder::inputVar(unsigned i) {
+  return lit(AigLit(_aig.inputs()[i]));
+}
+
+int CnfEncoder::lit(AigLit l) {
+  uint32_t n = node(l);
+  if (n >= _vars.size()) {
+    _vars.resize(_aig.numNodes(), 0);
+    _done.resize(_aig.numNodes(), 0);
+  }
+  if (_vars[n] == 0)
+    _vars[n] = _cnf.newVar();
+  return sign(l) ? -_vars[n] : _vars[n];
+}
+
+void CnfEncoder::require(AigLit root, unsigned rootPol) {
+  _stack.push_back(std::make_pair(root, rootPol));
+  while (!_stack.empty()) {
+    AigLit l = _stack.back().first;
+    unsigned pol = _polarity ? _stack.back().second : (POS | NEG);
+    _stack.pop_back();
+
+    uint32_t n = node(l);
+    // a complemented edge swaps the polarity the node is used in
+    if (sign(l) && pol != (POS | NEG))
+      pol ^= POS | NEG;
+    lit(l); // makes sure the node has a variable and _done is large enough
+    unsigned todo = pol & ~_done[n];
+    if (!todo) continue;
+    _done[n] |= todo;
+    encode(n, todo);
+  }
+}
+
+void CnfEncoder::encode(uint32_t n, unsigned pol) {
+  const int v = _vars[n];
+  switch (_aig.type(n)) {
+    case Aig::CONST:
+      if (_done[n] == pol)   // first time only
+        _cnf.addClause(-v);
+      break;
+
+    case Aig::INPUT:
+      break;
+
+    case Aig::AND: {
+      AigLit s, t, e;
+      if (_muxes && _aig.isMux(n, s, t, e)) {
+        // v <-> (s ? t : e)
+        if (pol & POS) {
+          _cnf.addClause(-v, -lit(s), lit(t));
+          _cnf.addClause(-v,  lit(s), lit(e));
+        }
+        if (pol & NEG) {
+          _cnf.addClause( v, -lit(s), -lit(t));
+          _cnf.addClause( v,  lit(s), -lit(e));
+        }
+        _stack.push_back(std::make_pair(s, (unsigned)(POS | NEG)));
+        _stack.push_back(std::make_pair(t, pol));
+        _stack.push_back(std::make_pair(e, pol));
+        break;
+      }
+      AigLit a = _aig.fanin0(n), b = _aig.fanin1(n);
+      if (pol & POS) {
+        _cnf.addClause(-v, lit(a));
+        _cnf.addClause(-v, lit(b));
+      }
+      if (pol & NEG)
+        _cnf.addClause(v, -lit(a), -lit(b));
+      _stack.push_back(std::make_pair(a, pol));
+      _stack.push_back(std::make_pair(b, pol));
+      break;
+    }
+
+    case Aig::XOR: {
+      AigLit a = _aig.fanin0(n), b = _aig.fanin1(n);
+      if (pol & POS) {
+        _cnf.addClause(-v,  lit(a),  lit(b));
+        _cnf.addClause(-v, -lit(a), -lit(b));
+      }
+      if (pol & NEG) {
+        _cnf.addClause( v, -lit(a),  lit(b));
+        _cnf.addClause( v,  lit(a), -lit(b));
+      }
+      // both values of a and b matter in either direction
+      _stack.push_back(std::make_pair(a, (unsigned)(POS | NEG)));
+      _stack.push_back(std::make_pair(b, (unsigned)(POS | NEG)));
+      break;
+    }
+  }
+}
+
+std::vector<std::string> CnfEncoder::symbols() const {
+  std::vector<std::string> names(_cnf.numVars + 1);
+  for (unsigned i = 0; i < _aig.numInputs(); ++i) {
+    int v = var(_aig.inputs()[i]);
+    if (v == 0) continue;
+    names[v] = _aig.inputName(i);
+    if (names[v].empty()) {
+      std::ostringstream name;
+      name << "i" << i;
+      names[v] = name.str();
+    }
+  }
+  return names;
+}
+
+std::vector<Signal*> addCnf(sword& solver, const Cnf& cnf, const std::vector<std::string>* names) {
+  std::vector<PSignal> vars(cnf.numVars + 1, PSignal());
+  std::vector<PSignal> negated(cnf.numVars + 1, PSignal());
+  for (int v = 1; v <= cnf.numVars; ++v) {
+    if (names && v < (int)names->size() && !(*names)[v].empty()) {
+      vars[v] = solver.addVariable(1, (*names)[v]);
+      continue;
+    }
+    std::ostringstream name;
+    name << "v" << v;
+    vars[v] = solver.addVariable(1, name.str());
+  }
+
+  std::vector<PSignal> clause;
+  for (unsigned i = 0; i < cnf.numClauses(); ++i) {
+    if (cnf.size(i) == 0) {
+      solver.addAssertion(solver.addConstant(1, 0ul));
+      continue;
+    }
+    if (cnf.size(i) == 1) {
+      int l = *cnf.begin(i);
+      solver.addAssertion(vars[std::abs(l)], l > 0);
+      continue;
+    }
+    clause.clear();
+    for (const int* l = cnf.begin(i); l != cnf.end(i); ++l) {
+      int v = std::abs(*l);
+      if (*l > 0) {
+        clause.push_back(vars[v]);
+      } else {
+        if (!negated[v])
+          negated[v] = solver.addOperator(NOT, vars[v]);
+        clause.push_back(negated[v]);
+      }
+    }
+    solver.addAssertion(solver.addOperator(OR, &clause));
+  }
+  return vars;
+}
+
+} /* namespace rsynth */
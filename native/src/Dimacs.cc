@@ -0,0 +1,76 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "Dimacs.h"
+
+#include <cstdlib>
+#include <istream>
+#include <ostream>
+#include <sstream>
+
+namespace rsynth {
+
+bool writeDimacs(std::ostream& out, const Cnf& cnf, const std::vector<std::string>& names) {
+  for (unsigned v = 1; v < names.size() && (int)v <= cnf.numVars; ++v)
+    if (!names[v].empty())
+      out << "c v " << v << " " << names[v] << "\n";
+  out << "p cnf " << cnf.numVars << " " << cnf.numClauses() << "\n";
+  for (unsigned i = 0; i < cnf.numClauses(); ++i) {
+    for (const int* l = cnf.begin(i); l != cnf.end(i); ++l)
+      out << *l << " ";
+    out << "0\n";
+  }
+  return out.good();
+}
+
+bool readDimacs(std::istream& in, Cnf& cnf, std::vector<std::string>* names) {
+  std::string line;
+  unsigned numClauses = 0, before = cnf.numClauses();
+  bool header = false;
+  while (!header && std::getline(in, line)) {
+    std::istringstream s(line);
+    std::string tag;
+    if (!(s >> tag)) continue;
+    if (tag == "p") {
+      std::string format;
+      int numVars;
+      if (!(s >> format >> numVars >> numClauses) || format != "cnf" || numVars < 0)
+        return false;
+      while (cnf.numVars < numVars)
+        cnf.newVar();
+      header = true;
+    } else if (tag == "c") {
+      int v;
+      std::string name;
+      if (names && s >> tag && tag == "v" && s >> v && v > 0 && std::getline(s >> std::ws, name)) {
+        if ((int)names->size() <= v)
+          names->resize(v + 1);
+        (*names)[v] = name;
+      }
+    } else {
+      return false;
+    }
+  }
+  if (!header)
+    return false;
+
+  std::vector<int> clause;
+  std::string token;
+  while (in >> token) {
+    if (token[0] == 'c') {
+      std::getline(in, token);
+      continue;
+    }
+    char* end;
+    long l = std::strtol(token.c_str(), &end, 10);
+    if (*end != 0 || std::labs(l) > cnf.numVars)
+      return false;
+    if (l == 0) {
+      cnf.addClause(clause);
+      clause.clear();
+    } else {
+      clause.push_back((int)l);
+    }
+  }
+  return clause.empty() && cnf.numClauses() - before == numClauses;
+}
+
+} /* namespace rsynth */
@@ -0,0 +1,110 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "DistanceTable.h"
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+namespace rsynth {
+
+namespace {
+
+const char MAGIC[8] = { 'R', 'S', 'B', 'F', 'S', 'D', '1', '\n' };
+
+uint64_t readLittle(std::istream& in, unsigned bytes) {
+  unsigned char buf[8];
+  if (!in.read(reinterpret_cast<char*>(buf), bytes)) return 0;
+  uint64_t value = 0;
+  for (unsigned i = bytes; i-- > 0; )
+    value = value << 8 | buf[i];
+  return value;
+}
+
+void writeLittle(std::ostream& out, uint64_t value, unsigned bytes) {
+  unsigned char buf[8];
+  for (unsigned i = 0; i < bytes; ++i, value >>= 8)
+    buf[i] = value & 0xff;
+  out.write(reinterpret_cast<const char*>(buf), bytes);
+}
+
+} /* namespace */
+
+DistanceTable::DistanceTable(unsigned width, unsigned maxDepth,
+                             std::vector<std::pair<uint64_t, unsigned char> > distances)
+  : _width(width)
+  , _maxDepth(maxDepth)
+{
+  std::sort(distances.begin(), distances.end());
+  for (unsigned i = 0; i < distances.size(); ++i) {
+    _keys.push_back(distances[i].first);
+    _distances.push_back(distances[i].second);
+  }
+}
+
+uint64_t DistanceTable::key(const std::vector<unsigned>& target) {
+  uint64_t key = 0;
+  for (unsigned row = target.size(); row-- > 0; )
+    key = key << 4 | target[row];
+  return key;
+}
+
+unsigned DistanceTable::lowerBound(const std::vector<unsigned>& target) const {
+  uint64_t k = key(target);
+  std::vector<uint64_t>::const_iterator it = std::lower_bound(_keys.begin(), _keys.end(), k);
+  if (it == _keys.end() || *it != k)
+    return _maxDepth + 1;
+  return _distances[it - _keys.begin()];
+}
+
+bool readDistances(std::istream& in, DistanceTable& table) {
+  char magic[8];
+  if (!in.read(magic, 8) || std::memcmp(magic, MAGIC, 8)) return false;
+  unsigned width = readLittle(in, 4);
+  unsigned maxDepth = readLittle(in, 4);
+  uint64_t count = readLittle(in, 8);
+  if (!in || width < 1 || width > 4) return false;
+
+  // at most (2^width)! permutations, and 9 bytes per entry left in the file
+  uint64_t permutations = 1;
+  for (uint64_t n = 2; n <= (uint64_t(1) << width); ++n)
+    permutations *= n;
+  if (count > permutations) return false;
+  std::streampos here = in.tellg();
+  if (here != std::streampos(-1) && in.seekg(0, std::ios::end)) {
+    uint64_t remaining = in.tellg() - here;
+    in.seekg(here);
+    if (count > remaining / 9) return false;
+    table._keys.reserve(count);
+  }
+  in.clear();
+
+  // a stream that cannot seek is read as far as it goes before allocating
+  table._width = width;
+  table._maxDepth = maxDepth;
+  table._keys.clear();
+  for (uint64_t i = 0; i < count; ++i) {
+    uint64_t key = readLittle(in, 8);
+    if (!in || (i > 0 && key <= table._keys.back())) return false;
+    table._keys.push_back(key);
+  }
+  table._distances.resize(count);
+  if (count && !in.read(reinterpret_cast<char*>(&table._distances[0]), count)) return false;
+  for (uint64_t i = 0; i < count; ++i)
+    if (table._distances[i] > maxDepth) return false;
+  return true;
+}
+
+bool writeDistances(std::ostream& out, const DistanceTable& table) {
+  out.write(MAGIC, 8);
+  writeLittle(out, table._width, 4);
+  writeLittle(out, table._maxDepth, 4);
+  writeLittle(out, table._keys.size(), 8);
+  for (unsigned i = 0; i < table._keys.size(); ++i)
+    writeLittle(out, table._keys[i], 8);
+  if (!table._distances.empty())
+    out.write(reinterpret_cast<const char*>(&table._distances[0]), table._distances.size());
+  return bool(out);
+}
+
+} /* namespace rsynth */
@@ -0,0 +1,128 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "EquivalenceChecker.h"
+#include "Aig.h"
+#include "AigToSword.h"
+#include "Random.h"
+#include "Sweep.h"
+
+#include "libsword.h"
+
+#include <cstdio>
+
+using namespace SWORD;
+
+namespace rsynth {
+
+namespace {
+
+/**
+ * 64 patterns per wire through the cascade
+ */
+void simulateWords(const std::vector<Gate>& gates, std::vector<uint64_t>& state) {
+  for (unsigned p = 0; p < gates.size(); ++p)
+    state[gates[p].t] ^= state[gates[p].c1] | ~state[gates[p].c2];
+}
+
+std::vector<AigLit> addOutputs(Aig& aig, const std::vector<Gate>& gates, std::vector<AigLit> state) {
+  for (unsigned p = 0; p < gates.size(); ++p) {
+    const Gate& g = gates[p];
+    state[g.t] = aig.addXor(state[g.t], aig.addOr(state[g.c1], ~state[g.c2]));
+  }
+  return state;
+}
+
+} /* namespace */
+
+uint64_t apply(const std::vector<Gate>& gates, uint64_t state) {
+  for (unsigned p = 0; p < gates.size(); ++p) {
+    const Gate& g = gates[p];
+    if (((state >> g.c1) & 1) || !((state >> g.c2) & 1))
+      state ^= uint64_t(1) << g.t;
+  }
+  return state;
+}
+
+EquivalenceChecker::EquivalenceChecker(unsigned width, unsigned words)
+  : _width(width)
+  , _words(words)
+  , _seed(0x9e3779b97f4a7c15ull)
+{ }
+
+bool EquivalenceChecker::simulateDifferent(const std::vector<Gate>& a, const std::vector<Gate>& b,
+                                           uint64_t& counterexample) {
+  std::vector<uint64_t> inputs(_width), outA, outB;
+  for (unsigned w = 0; w < _words; ++w) {
+    for (unsigned i = 0; i < _width; ++i)
+      inputs[i] = xorshift(_seed);
+    outA = inputs;
+    outB = inputs;
+    simulateWords(a, outA);
+    simulateWords(b, outB);
+    uint64_t diff = 0;
+    for (unsigned i = 0; i < _width; ++i)
+      diff |= outA[i] ^ outB[i];
+    if (diff) {
+      unsigned bit = __builtin_ctzll(diff);
+      counterexample = 0;
+      for (unsigned i = 0; i < _width; ++i)
+        counterexample |= ((inputs[i] >> bit) & 1) << i;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool EquivalenceChecker::equivalent(const std::vector<Gate>& a, const std::vector<Gate>& b,
+                                    uint64_t& counterexample) {
+  ++_stats.checks;
+  if (simulateDifferent(a, b, counterexample)) {
+    ++_stats.simulated;
+    return false;
+  }
+
+  Aig aig;
+  std::vector<AigLit> inputs;
+  for (unsigned i = 0; i < _width; ++i) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "x_%u", i);
+    inputs.push_back(aig.addInput(name));
+  }
+  std::vector<AigLit> outA = addOutputs(aig, a, inputs);
+  std::vector<AigLit> outB = addOutputs(aig, b, inputs);
+  _stats.nodes = aig.numNodes();
+  if (outA == outB) {
+    ++_stats.structural;
+    return true;
+  }
+
+  // the two cascades compute the same intermediate functions in different
+  // ways; merging those first leaves sword a small miter or none at all.
+  // The miter is built after the sweep, which would otherwise compare the
+  // XORs of outputs that differ, a hard proof over both cones
+  std::vector<AigLit> map;
+  SweepStats sweepStats;
+  Aig swept = sweep(aig, map, &sweepStats);
+  _stats.merged = sweepStats.merged;
+  std::vector<AigLit> diff;
+  for (unsigned i = 0; i < _width; ++i)
+    diff.push_back(swept.addXor(map[node(outA[i])] ^ sign(outA[i]), map[node(outB[i])] ^ sign(outB[i])));
+  AigLit miter = swept.addOr(diff);
+  if (miter == aig_False) {
+    ++_stats.swept;
+    return true;
+  }
+
+  sword solver;
+  AigToSword lower(swept, solver);
+  solver.addAssertion(lower.signal(miter));
+  ++_stats.solved;
+  if (!solver.solve())
+    return true;
+  counterexample = 0;
+  for (unsigned i = 0; i < _width; ++i)
+    if (lower.inputValue(i))
+      counterexample |= uint64_t(1) << i;
+  return false;
+}
+
+} /* namespace rsynth */
@@ -0,0 +1,232 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "InstanceBatch.h"
+#include "Aig.h"
+#include "AigToSword.h"
+#include "Aiger.h"
+#include "Cnf.h"
+#include "Dimacs.h"
+#include "SmtReader.h"
+
+#include "libsword.h"
+
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <istream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <sys/time.h>
+#include <thread>
+#include <time.h>
+
+namespace rsynth {
+
+namespace {
+
+double now() {
+  timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+double threadTime() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+bool endsWith(const std::string& s, const char* suffix) {
+  size_t n = std::strlen(suffix);
+  return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+/**
+ * loads the instance into solver, writes its sizes to stats
+ *
+ * @return false with the reason in error
+ */
+bool load(const Instance& instance, SWORD::sword& solver, std::ostream& stats, std::string& error) {
+  const std::string& path = instance.path;
+  if (path.empty() || endsWith(path, ".smt")) {
+    SmtReader reader(solver);
+    bool ok = path.empty()
+      ? reader.parse(instance.text.data(), instance.text.data() + instance.text.size())
+      : reader.parseFile(path);
+    if (!ok) {
+      error = reader.error();
+      return false;
+    }
+    stats << "assertions=" << reader.numAssertions();
+    if (!reader.status().empty())
+      stats << " status=" << reader.status();
+  } else if (endsWith(path, ".cnf")) {
+    std::ifstream in(path.c_str());
+    Cnf cnf;
+    std::vector<std::string> names;
+    if (!readDimacs(in, cnf, &names)) {
+      error = "cannot read DIMACS";
+      return false;
+    }
+    addCnf(solver, cnf, &names);
+    stats << "vars=" << cnf.numVars << " clauses=" << cnf.numClauses();
+  } else if (endsWith(path, ".aig") || endsWith(path, ".aag")) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    Aig aig;
+    std::vector<AigLit> outputs;
+    if (!readAiger(in, aig, outputs)) {
+      error = "cannot read AIGER";
+      return false;
+    }
+    AigToSword lower(aig, solver);
+    for (unsigned i = 0; i < outputs.size(); ++i)
+      solver.addAssertion(lower.signal(outputs[i]));
+    stats << "inputs=" << aig.numInputs() << " ands=" << aig.numAnds()
+          << " xors=" << aig.numXors();
+  } else {
+    error = "unknown format";
+    return false;
+  }
+  return true;
+}
+
+} /* namespace */
+
+std::string solveInstance(const Instance& instance) {
+  double start = now(), cpu = threadTime();
+  std::ostringstream line, stats;
+  line.setf(std::ios::fixed);
+  line.precision(3);
+  stats.setf(std::ios::fixed);
+  stats.precision(3);
+
+  std::string error;
+  try {
+    SWORD::sword solver;
+    std::ostringstream sizes;
+    if (load(instance, solver, sizes, error)) {
+      double loaded = now();
+      bool sat = solver.solve();
+      double solved = now();
+      stats << "load=" << loaded - start << " solve=" << solved - loaded
+            << " cpu=" << threadTime() - cpu << " " << sizes.str();
+      line << (sat ? "sat " : "unsat ") << solved - start << " " << stats.str();
+      return line.str();
+    }
+  } catch (const std::exception& e) {
+    error = std::string("exception: ") + e.what();
+  } catch (...) {
+    // what libsword throws on bad input is not a std::exception
+    error = "exception from sword";
+  }
+  line << "error " << now() - start << " " << error;
+  return line.str();
+}
+
+bool BenchmarkStream::fail(const char* message) {
+  _error = "line " + std::to_string(_line) + ": " + message;
+  return false;
+}
+
+bool BenchmarkStream::next(std::string& benchmark) {
+  benchmark.clear();
+  if (!_error.empty()) return false;
+  std::streambuf* in = _in.rdbuf();
+  unsigned depth = 0;
+  for (int c; (c = in->sbumpc()) != EOF; ) {
+    if (depth > 0) benchmark += char(c);
+    switch (c) {
+      case '\n':
+        ++_line;
+        break;
+      case ';':
+        for (; (c = in->sgetc()) != EOF && c != '\n'; in->sbumpc())
+          if (depth > 0) benchmark += char(c);
+        break;
+      case '"':
+      case '{': {
+        if (depth == 0)
+          return fail("text between benchmarks");
+        char close = c == '"' ? '"' : '}';
+        while ((c = in->sbumpc()) != EOF) {
+          benchmark += char(c);
+          if (c == '\n') ++_line;
+          if (c == close) break;
+          if (c == '\\' && (c = in->sbumpc()) != EOF) {
+            benchmark += char(c);
+            if (c == '\n') ++_line;
+          }
+        }
+        break;
+      }
+      case '(':
+        if (depth++ == 0) benchmark = "(";
+        break;
+      case ')':
+        if (depth == 0)
+          return fail("unbalanced ')'");
+        if (--depth == 0)
+          return true;
+        break;
+      case ' ': case '\t': case '\r':
+        break;
+      default:
+        if (depth == 0)
+          return fail("text between benchmarks");
+    }
+  }
+  if (depth != 0)
+    return fail("benchmark not closed");
+  return false;
+}
+
+void solveInstances(const std::function<bool(Instance&)>& next, unsigned threads,
+                    const std::function<void(size_t, const Instance&, const std::string&)>& report) {
+  // solved instances waiting for an earlier one, by index
+  std::map<size_t, std::pair<Instance, std::string> > done;
+  size_t taken = 0, reported = 0;
+  bool more = true;
+  std::mutex input, output;
+  if (threads == 0) threads = 1;
+
+  std::vector<std::thread> pool;
+  for (unsigned t = 0; t < threads; ++t) {
+    pool.push_back(std::thread([&]() {
+      for (;;) {
+        Instance instance;
+        size_t i;
+        {
+          std::lock_guard<std::mutex> guard(input);
+          if (!more || !(more = next(instance))) return;
+          i = taken++;
+        }
+        std::string result = solveInstance(instance);
+        std::string().swap(instance.text);
+        std::lock_guard<std::mutex> guard(output);
+        std::pair<Instance, std::string>& entry = done[i];
+        std::swap(entry.first, instance);
+        entry.second.swap(result);
+        for (std::map<size_t, std::pair<Instance, std::string> >::iterator it = done.begin();
+             it != done.end() && it->first == reported; it = done.begin(), ++reported) {
+          report(reported, it->second.first, it->second.second);
+          done.erase(it);
+        }
+      }
+    }));
+  }
+  for (unsigned t = 0; t < pool.size(); ++t)
+    pool[t].join();
+}
+
+void solveInstances(const std::vector<Instance>& instances, unsigned threads,
+                    const std::function<void(size_t, const Instance&, const std::string&)>& report) {
+  size_t n = 0;
+  if (threads > instances.size()) threads = instances.size();
+  solveInstances([&](Instance& instance) {
+    if (n == instances.size()) return false;
+    instance = instances[n++];
+    return true;
+  }, threads, report);
+}
+
+} /* namespace rsynth */
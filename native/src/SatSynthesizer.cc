@@ -0,0 +1,372 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "SatSynthesizer.h"
+#include "DistanceTable.h"
+#include "Word.h"
+
+#include "libsword.h"
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace SWORD;
+
+namespace rsynth {
+
+namespace {
+
+// longest prefix or suffix enumerated against the distance table
+const unsigned MAX_CUT_GATES = 3;
+
+/**
+ * one-hot word of width inputs named "<prefix>_<position>_<wire>",
+ * exactly-one asserted
+ */
+std::vector<AigLit> addOneHot(Aig& aig, AigToSword& lower, sword& solver,
+                              const char* prefix, unsigned position, unsigned width) {
+  std::vector<AigLit> word;
+  for (unsigned i = 0; i < width; ++i) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s_%u_%u", prefix, position, i);
+    word.push_back(aig.addInput(name));
+  }
+  solver.addAssertion(lower.signal(aig.addOr(word)));
+  solver.addAssertion(lower.signal(addAtMost(aig, word, 1)));
+  return word;
+}
+
+/**
+ * the state bit selected by a one-hot word
+ */
+AigLit addSelected(Aig& aig, const std::vector<AigLit>& oneHot, const std::vector<AigLit>& state) {
+  std::vector<AigLit> terms;
+  for (unsigned i = 0; i < state.size(); ++i)
+    terms.push_back(aig.addAnd(oneHot[i], state[i]));
+  return aig.addOr(terms);
+}
+
+/**
+ * a < b for one-hot words
+ */
+AigLit addOneHotLess(Aig& aig, const std::vector<AigLit>& a, const std::vector<AigLit>& b) {
+  std::vector<AigLit> terms;
+  AigLit below = aig_False;   // a selects an index below i
+  for (unsigned i = 0; i < a.size(); ++i) {
+    terms.push_back(aig.addAnd(below, b[i]));
+    below = aig.addOr(below, a[i]);
+  }
+  return aig.addOr(terms);
+}
+
+AigLit addOneHotEqual(Aig& aig, const std::vector<AigLit>& a, const std::vector<AigLit>& b) {
+  std::vector<AigLit> terms;
+  for (unsigned i = 0; i < a.size(); ++i)
+    terms.push_back(aig.addAnd(a[i], b[i]));
+  return aig.addOr(terms);
+}
+
+/**
+ * gate a before gate b in (t, c1, c2) order, the order of allGates
+ */
+AigLit addGateLess(Aig& aig, const std::vector<AigLit>* a, const std::vector<AigLit>* b) {
+  AigLit less = addOneHotLess(aig, a[2], b[2]);
+  for (unsigned k = 2; k-- > 0; )
+    less = aig.addOr(addOneHotLess(aig, a[k], b[k]), aig.addAnd(addOneHotEqual(aig, a[k], b[k]), less));
+  return less;
+}
+
+/**
+ * the wire relabellings sigma with target(sigma(r)) = sigma(target(r)),
+ * all of them up to width 6, transpositions above; the identity is left out
+ */
+std::vector<std::vector<unsigned> > symmetries(unsigned width, const std::vector<unsigned>& target) {
+  std::vector<std::vector<unsigned> > candidates, result;
+  std::vector<unsigned> sigma(width);
+  for (unsigned i = 0; i < width; ++i)
+    sigma[i] = i;
+  if (width <= 6) {
+    while (std::next_permutation(sigma.begin(), sigma.end()))
+      candidates.push_back(sigma);
+  } else {
+    for (unsigned i = 0; i < width; ++i)
+      for (unsigned j = i + 1; j < width; ++j) {
+        candidates.push_back(sigma);
+        std::swap(candidates.back()[i], candidates.back()[j]);
+      }
+  }
+
+  for (unsigned n = 0; n < candidates.size(); ++n) {
+    const std::vector<unsigned>& s = candidates[n];
+    bool invariant = true;
+    for (unsigned row = 0; row < target.size() && invariant; ++row) {
+      unsigned image = 0, relabelled = 0;
+      for (unsigned i = 0; i < width; ++i) {
+        image |= ((row >> i) & 1) << s[i];
+        relabelled |= ((target[row] >> i) & 1) << s[i];
+      }
+      invariant = target[image] == relabelled;
+    }
+    if (invariant)
+      result.push_back(s);
+  }
+  return result;
+}
+
+/**
+ * the permutation left after gate g: as the first gate (rest applied
+ * after g) or as the last one (suffix, rest applied before g)
+ */
+std::vector<unsigned> peel(const Gate& g, const std::vector<unsigned>& rest, bool suffix) {
+  std::vector<unsigned> next(rest.size());
+  for (unsigned row = 0; row < rest.size(); ++row) {
+    if (suffix) next[row] = apply(g, rest[row]);
+    else        next[apply(g, row)] = rest[row];
+  }
+  return next;
+}
+
+/**
+ * "j more gates can be peeled off rest leaving at most budget gates"
+ */
+bool peelable(const DistanceTable& table, const std::vector<Gate>& gates,
+              const std::vector<unsigned>& rest, unsigned j, unsigned budget, bool suffix) {
+  if (j == 0)
+    return table.lowerBound(rest) <= budget;
+  for (unsigned g = 0; g < gates.size(); ++g)
+    if (peelable(table, gates, peel(gates[g], rest, suffix), j - 1, budget, suffix))
+      return true;
+  return false;
+}
+
+} /* namespace */
+
+SatSynthesizer::SatSynthesizer(sword& solver, unsigned width)
+  : _solver(solver)
+  , _width(width)
+  , _gates(allGates(width))
+  , _gateIndex(width * width * width, 0)
+  , _lower(_aig, solver)
+  , _states(1u << width)
+  , _lazy(false)
+  , _ordering(true)
+  , _wires(false)
+  , _table(0)
+{
+  _ordered = _aig.addInput("ordered");
+  for (unsigned g = 0; g < _gates.size(); ++g)
+    _gateIndex[(_gates[g].t * width + _gates[g].c1) * width + _gates[g].c2] = g;
+}
+
+void SatSynthesizer::addPosition() {
+  unsigned p = _t.size();
+  _t.push_back(addOneHot(_aig, _lower, _solver, "t", p, _width));
+  _c1.push_back(addOneHot(_aig, _lower, _solver, "c1", p, _width));
+  _c2.push_back(addOneHot(_aig, _lower, _solver, "c2", p, _width));
+  for (unsigned i = 0; i < _width; ++i) {
+    _solver.addAssertion(_lower.signal(~_aig.addAnd(_t[p][i], _c1[p][i])));
+    _solver.addAssertion(_lower.signal(~_aig.addAnd(_t[p][i], _c2[p][i])));
+    _solver.addAssertion(_lower.signal(~_aig.addAnd(_c1[p][i], _c2[p][i])));
+  }
+  for (unsigned i = 0; i < _encoded.size(); ++i)
+    extendRow(_encoded[i]);
+  ++_stats.positions;
+
+  if (p > 0) {
+    // commuting neighbours in increasing order, when enabled
+    std::vector<AigLit> conflict;
+    for (unsigned i = 0; i < _width; ++i) {
+      conflict.push_back(_aig.addAnd(_t[p - 1][i], _aig.addOr(_c1[p][i], _c2[p][i])));
+      conflict.push_back(_aig.addAnd(_t[p][i], _aig.addOr(_c1[p - 1][i], _c2[p - 1][i])));
+    }
+    std::vector<AigLit> a, b;
+    a.push_back(_aig.addOr(conflict));
+    const std::vector<AigLit> before[3] = { _t[p - 1], _c1[p - 1], _c2[p - 1] };
+    const std::vector<AigLit> after[3] = { _t[p], _c1[p], _c2[p] };
+    a.push_back(addGateLess(_aig, before, after));
+    a.push_back(~_ordered);
+    _solver.addAssertion(_lower.signal(_aig.addOr(a)));
+  }
+}
+
+void SatSynthesizer::addRow(unsigned row) {
+  // zero positions: the row is its own input
+  std::vector<AigLit> state;
+  for (unsigned w = 0; w < _width; ++w)
+    state.push_back((row >> w) & 1 ? aig_True : aig_False);
+  _states[row].push_back(state);
+  while (_states[row].size() <= _t.size())
+    extendRow(row);
+  _encoded.push_back(row);
+  ++_stats.rows;
+}
+
+void SatSynthesizer::extendRow(unsigned row) {
+  unsigned p = _states[row].size() - 1;
+  const std::vector<AigLit>& before = _states[row].back();
+  AigLit active = _aig.addOr(addSelected(_aig, _c1[p], before), ~addSelected(_aig, _c2[p], before));
+  std::vector<AigLit> after;
+  for (unsigned w = 0; w < _width; ++w)
+    after.push_back(_aig.addXor(before[w], _aig.addAnd(_t[p][w], active)));
+  _states[row].push_back(after);
+}
+
+unsigned SatSynthesizer::lowerBound(unsigned width, const std::vector<unsigned>& target) {
+  unsigned changed = 0;
+  for (unsigned row = 0; row < target.size(); ++row)
+    changed |= target[row] ^ row;
+  unsigned n = 0;
+  for (unsigned w = 0; w < width; ++w)
+    n += (changed >> w) & 1;
+  return n;
+}
+
+void SatSynthesizer::assumeSymmetries(const std::vector<unsigned>& target) {
+  _solver.addAssumption(_lower.signal(_ordered), _ordering);
+  if (!_wires)
+    return;
+  std::vector<std::vector<unsigned> > sigmas = symmetries(_width, target);
+  const std::vector<AigLit> first[3] = { _t[0], _c1[0], _c2[0] };
+  for (unsigned n = 0; n < sigmas.size(); ++n) {
+    // the first gate relabelled: wire i becomes sigma[i]
+    std::vector<AigLit> relabelled[3];
+    for (unsigned k = 0; k < 3; ++k) {
+      relabelled[k].resize(_width);
+      for (unsigned i = 0; i < _width; ++i)
+        relabelled[k][sigmas[n][i]] = first[k][i];
+    }
+    _solver.addAssumption(_lower.signal(~addGateLess(_aig, relabelled, first)));
+  }
+}
+
+AigLit SatSynthesizer::addGateIn(unsigned position, const std::vector<bool>& allowed) {
+  std::vector<AigLit> terms;
+  for (unsigned g = 0; g < _gates.size(); ++g)
+    if (allowed[g])
+      terms.push_back(_aig.addAnd(_t[position][_gates[g].t],
+          _aig.addAnd(_c1[position][_gates[g].c1], _c2[position][_gates[g].c2])));
+  return _aig.addOr(terms);
+}
+
+bool SatSynthesizer::tableCuts(const std::vector<unsigned>& target, unsigned length,
+                               std::vector<AigLit>& cuts) {
+  cuts.clear();
+  if (!_table || _table->width() != _width)
+    return true;
+  if (length < _table->lowerBound(target))
+    return false;
+  // peeling j gates leaves length - j <= maxDepth, whose optimum the table knows
+  unsigned j = length > _table->maxDepth() ? length - _table->maxDepth() : 1;
+  if (j > MAX_CUT_GATES)
+    return true;
+  for (unsigned suffix = 0; suffix < 2; ++suffix) {
+    std::vector<bool> allowed(_gates.size(), false);
+    unsigned n = 0;
+    for (unsigned g = 0; g < _gates.size(); ++g)
+      if (peelable(*_table, _gates, peel(_gates[g], target, suffix), j - 1, length - j, suffix)) {
+        allowed[g] = true;
+        ++n;
+      }
+    if (n == 0)
+      return false;
+    if (n < _gates.size())
+      cuts.push_back(addGateIn(suffix ? length - 1 : 0, allowed));
+  }
+  return true;
+}
+
+std::vector<unsigned> SatSynthesizer::initialRows() const {
+  std::vector<unsigned> rows;
+  if (!_lazy) {
+    for (unsigned row = 0; row < _states.size(); ++row)
+      rows.push_back(row);
+  } else {
+    rows.push_back(0);
+    for (unsigned w = 0; w < _width; ++w)
+      rows.push_back(1u << w);
+  }
+  return rows;
+}
+
+bool SatSynthesizer::solveRows(const std::vector<unsigned>& target, unsigned length,
+                               std::vector<unsigned>& rows, std::vector<unsigned>& circuit) {
+  circuit.clear();
+  if (length == 0) {
+    for (unsigned row = 0; row < target.size(); ++row)
+      if (target[row] != row) return false;
+    return true;
+  }
+  while (_t.size() < length)
+    addPosition();
+  std::vector<AigLit> cuts;
+  if (!tableCuts(target, length, cuts)) {
+    ++_stats.skipped;
+    return false;
+  }
+
+  std::vector<std::vector<uint64_t> > table = truthTable(_width, target);
+  for (;;) {
+    for (unsigned i = 0; i < rows.size(); ++i) {
+      if (_states[rows[i]].empty())
+        addRow(rows[i]);
+      const std::vector<AigLit>& out = _states[rows[i]][length];
+      for (unsigned w = 0; w < _width; ++w)
+        _solver.addAssumption(_lower.signal(out[w]), (target[rows[i]] >> w) & 1);
+    }
+    for (unsigned i = 0; i < cuts.size(); ++i)
+      _solver.addAssumption(_lower.signal(cuts[i]), true);
+    assumeSymmetries(target);
+    ++_stats.calls;
+    if (!_solver.solve()) {
+      circuit.clear();   // drop the candidate of an earlier round
+      return false;
+    }
+
+    circuit.clear();
+    for (unsigned p = 0; p < length; ++p) {
+      unsigned t = 0, c1 = 0, c2 = 0;
+      for (unsigned i = 0; i < _width; ++i) {
+        unsigned base = 1 + 3 * _width * p;   // input 0 is _ordered
+        if (_lower.inputValue(base + i)) t = i;
+        if (_lower.inputValue(base + _width + i)) c1 = i;
+        if (_lower.inputValue(base + 2 * _width + i)) c2 = i;
+      }
+      circuit.push_back(_gateIndex[(t * _width + c1) * _width + c2]);
+    }
+    if (rows.size() == target.size())
+      return true;
+
+    // rows the candidate gets wrong, at most width of them spread over the table
+    std::vector<std::vector<uint64_t> > sim = simulateTable(_width, _gates, circuit);
+    std::vector<unsigned> wrong;
+    for (unsigned j = 0; j < sim[0].size(); ++j) {
+      uint64_t diff = 0;
+      for (unsigned w = 0; w < _width; ++w)
+        diff |= sim[w][j] ^ table[w][j];
+      for (; diff; diff &= diff - 1)
+        wrong.push_back(64 * j + __builtin_ctzll(diff));
+    }
+    if (wrong.empty())
+      return true;
+    ++_stats.refinements;
+    unsigned step = (wrong.size() + _width - 1) / _width;
+    for (unsigned i = 0; i < wrong.size(); i += step)
+      rows.push_back(wrong[i]);
+  }
+}
+
+bool SatSynthesizer::solve(const std::vector<unsigned>& target, unsigned length,
+                           std::vector<unsigned>& circuit) {
+  std::vector<unsigned> rows = initialRows();
+  return solveRows(target, length, rows, circuit);
+}
+
+bool SatSynthesizer::synthesize(const std::vector<unsigned>& target, unsigned maxLength,
+                                std::vector<unsigned>& circuit) {
+  // rows found for one length are constrained from the start at the next
+  std::vector<unsigned> rows = initialRows();
+  for (unsigned k = lowerBound(_width, target); k <= maxLength; ++k)
+    if (solveRows(target, k, rows, circuit))
+      return true;
+  return false;
+}
+
+} /* namespace rsynth */
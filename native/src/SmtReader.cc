@@ -0,0 +1,676 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "SmtReader.h"
+
+#include "libsword.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace SWORD;
+
+namespace rsynth {
+
+namespace {
+
+enum Kind {
+  CONNECTIVE,   // n-ary and/or/xor over formulas
+  PREDICATE,    // one-bit result
+  FUNCTION,     // width of the first argument, n-ary ones fold to the left
+  CONCATENATE,
+  IF_THEN_ELSE,
+  BINDER,       // let, flet
+  INDEXED       // extract[i:j], zero_extend[k], ...
+};
+
+struct OpInfo {
+  const char* name;
+  Kind        kind;
+  OPCODE      op;
+};
+
+// interned first, so their symbol ids are the table indices
+const OpInfo OPS[] = {
+  { "and",          CONNECTIVE,   AND          },
+  { "or",           CONNECTIVE,   OR           },
+  { "xor",          CONNECTIVE,   XOR          },
+  { "not",          FUNCTION,     NOT          },
+  { "implies",      PREDICATE,    IMPLIES      },
+  { "iff",          PREDICATE,    EQUAL        },
+  { "if_then_else", IF_THEN_ELSE, ITE          },
+  { "ite",          IF_THEN_ELSE, ITE          },
+  { "let",          BINDER,       UNKNOWN      },
+  { "flet",         BINDER,       UNKNOWN      },
+  { "=",            PREDICATE,    EQUAL        },
+  { "distinct",     PREDICATE,    NEQUAL       },
+  { "bvcomp",       PREDICATE,    EQUAL        },
+  { "bvult",        PREDICATE,    ULT          },
+  { "bvule",        PREDICATE,    ULE          },
+  { "bvugt",        PREDICATE,    UGT          },
+  { "bvuge",        PREDICATE,    UGE          },
+  { "bvslt",        PREDICATE,    SLT          },
+  { "bvsle",        PREDICATE,    SLE          },
+  { "bvsgt",        PREDICATE,    SGT          },
+  { "bvsge",        PREDICATE,    SGE          },
+  { "bvredor",      PREDICATE,    RED_OR       },
+  { "bvredand",     PREDICATE,    RED_AND      },
+  { "bvnot",        FUNCTION,     NOT          },
+  { "bvneg",        FUNCTION,     NEG          },
+  { "bvadd",        FUNCTION,     ADD          },
+  { "bvsub",        FUNCTION,     SUB          },
+  { "bvmul",        FUNCTION,     MUL          },
+  { "bvudiv",       FUNCTION,     UDIV         },
+  { "bvurem",       FUNCTION,     UREM         },
+  { "bvsdiv",       FUNCTION,     SDIV         },
+  { "bvsrem",       FUNCTION,     SREM         },
+  { "bvsmod",       FUNCTION,     SMOD         },
+  { "bvand",        FUNCTION,     AND          },
+  { "bvor",         FUNCTION,     OR           },
+  { "bvxor",        FUNCTION,     XOR          },
+  { "bvnand",       FUNCTION,     NAND         },
+  { "bvnor",        FUNCTION,     NOR          },
+  { "bvxnor",       FUNCTION,     XNOR         },
+  { "bvshl",        FUNCTION,     LSHL         },
+  { "bvlshr",       FUNCTION,     LSHR         },
+  { "bvashr",       FUNCTION,     ASHR         },
+  { "concat",       CONCATENATE,  CONCAT       },
+  { "extract",      INDEXED,      EXTRACT      },
+  { "zero_extend",  INDEXED,      ZERO_EXTEND  },
+  { "sign_extend",  INDEXED,      SIGN_EXTEND  },
+  { "repeat",       INDEXED,      REPEAT       },
+  { "rotate_left",  INDEXED,      ROTATE_LEFT  },
+  { "rotate_right", INDEXED,      ROTATE_RIGHT },
+};
+const unsigned NUM_OPS = sizeof(OPS) / sizeof(OPS[0]);
+
+struct Token {
+  enum Type { END, LPAREN, RPAREN, SYMBOL, OTHER, ERROR };
+  Type        type;
+  const char* begin;
+  const char* end;
+
+  size_t size() const { return end - begin; }
+  bool is(const char* s) const {
+    return size() == std::strlen(s) && !std::memcmp(begin, s, size());
+  }
+  std::string str() const { return std::string(begin, end); }
+};
+
+class Lexer {
+public:
+  Lexer(const char* first, const char* last) : _p(first), _end(last), _line(1) { }
+
+  unsigned line() const { return _line; }
+
+  Token next() {
+    for (;;) {
+      while (_p != _end && (*_p == ' ' || *_p == '\t' || *_p == '\r' || *_p == '\n'))
+        if (*_p++ == '\n') ++_line;
+      if (_p == _end || *_p != ';') break;
+      while (_p != _end && *_p != '\n')
+        ++_p;
+    }
+    Token t;
+    t.begin = _p;
+    if (_p == _end) {
+      t.type = Token::END;
+    } else if (*_p == '(' || *_p == ')') {
+      t.type = *_p++ == '(' ? Token::LPAREN : Token::RPAREN;
+    } else if (*_p == '"' || *_p == '{') {
+      // strings and user values, with backslash escapes
+      char close = *_p++ == '"' ? '"' : '}';
+      while (_p != _end && *_p != close) {
+        if (*_p == '\n') ++_line;
+        if (*_p++ == '\\' && _p != _end) ++_p;
+      }
+      t.type = _p == _end ? Token::ERROR : Token::OTHER;
+      if (_p != _end) ++_p;
+    } else {
+      while (_p != _end && !std::strchr(" \t\r\n();\"{", *_p))
+        ++_p;
+      t.type = Token::SYMBOL;
+    }
+    t.end = _p;
+    return t;
+  }
+
+private:
+  const char* _p;
+  const char* _end;
+  unsigned    _line;
+};
+
+/**
+ * open addressing table of symbol names; the names are not copied but
+ * point into the parsed text (or the static operator table)
+ */
+class SymbolTable {
+public:
+  SymbolTable() : _table(1024, 0) {
+    for (unsigned i = 0; i < NUM_OPS; ++i)
+      intern(OPS[i].name, OPS[i].name + std::strlen(OPS[i].name));
+  }
+
+  uint32_t intern(const char* first, const char* last) {
+    if (2 * (_names.size() + 1) > _table.size())
+      rehash();
+    uint32_t mask = _table.size() - 1, len = last - first;
+    for (uint32_t i = hash(first, len) & mask; ; i = (i + 1) & mask) {
+      if (_table[i] == 0) {
+        _names.push_back(std::make_pair(first, len));
+        _table[i] = _names.size();
+        return _names.size() - 1;
+      }
+      const std::pair<const char*, uint32_t>& n = _names[_table[i] - 1];
+      if (n.second == len && !std::memcmp(n.first, first, len))
+        return _table[i] - 1;
+    }
+  }
+
+  unsigned size() const { return _names.size(); }
+
+private:
+  static uint32_t hash(const char* s, uint32_t len) {
+    uint32_t h = 2166136261u;
+    for (uint32_t i = 0; i < len; ++i)
+      h = (h ^ (unsigned char)s[i]) * 16777619u;
+    return h;
+  }
+
+  void rehash() {
+    std::vector<uint32_t> table(2 * _table.size(), 0);
+    uint32_t mask = table.size() - 1;
+    for (uint32_t id = 0; id < _names.size(); ++id) {
+      uint32_t i = hash(_names[id].first, _names[id].second) & mask;
+      while (table[i] != 0)
+        i = (i + 1) & mask;
+      table[i] = id + 1;
+    }
+    _table.swap(table);
+  }
+
+  std::vector<std::pair<const char*, uint32_t> > _names;
+  std::vector<uint32_t> _table;   // symbol id + 1, 0 is empty
+};
+
+bool parseUnsigned(const char* first, const char* last, unsigned& x) {
+  if (first == last || last - first > 9) return false;
+  x = 0;
+  for (; first != last; ++first) {
+    if (*first < '0' || *first > '9') return false;
+    x = 10 * x + (*first - '0');
+  }
+  return true;
+}
+
+/**
+ * the low width bits of a decimal digit string as a binary string, most
+ * significant bit first, by repeated halving of the digits
+ */
+std::string decimalToBinary(std::string digits, unsigned width) {
+  std::string bits(width, '0');
+  for (unsigned i = width; i > 0; --i) {
+    unsigned carry = 0;
+    for (std::string::iterator d = digits.begin(); d != digits.end(); ++d) {
+      unsigned x = 10 * carry + (*d - '0');
+      *d = char('0' + x / 2);
+      carry = x % 2;
+    }
+    bits[i - 1] = char('0' + carry);
+  }
+  return bits;
+}
+
+} /* namespace */
+
+/**
+ * one parse of one input, see SmtReader
+ */
+class SmtParser {
+public:
+  SmtParser(SmtReader& reader, const char* first, const char* last)
+    : _reader(reader), _solver(reader._solver), _lexer(first, last)
+    , _depth(0), _true(0), _false(0)
+  { }
+
+  bool parseBenchmark();
+
+private:
+  struct Term {
+    PSignal  signal;
+    unsigned width;
+  };
+
+  struct Frame {
+    unsigned op;
+    unsigned index0, index1;
+    uint32_t var;           // let: the bound symbol
+    bool     bound;         // let: binding done, the body follows
+    std::vector<Term> args;
+  };
+
+  bool fail(const std::string& message) {
+    std::ostringstream s;
+    s << "line " << _lexer.line() << ": " << message;
+    _reader._error = s.str();
+    return false;
+  }
+
+  bool expect(Token::Type type, const char* what) {
+    if (_lexer.next().type != type)
+      return fail(std::string("expected ") + what);
+    return true;
+  }
+
+  uint32_t intern(const Token& t) {
+    uint32_t id = _symbols.intern(t.begin, t.end);
+    if (id >= _values.size())
+      _values.resize(id + 1, Term());
+    return id;
+  }
+
+  Term constant(bool b) {
+    PSignal& s = b ? _true : _false;
+    if (!s) s = _solver.addConstant(1, b ? 1ul : 0ul);
+    Term t = { s, 1 };
+    return t;
+  }
+
+  bool parseWidth(const Token& t, unsigned& width);
+  bool parseDeclarations(bool predicates);
+  bool skipValue();
+  bool parseTerm(Term& result);
+  bool parseHead(Frame& f);
+  bool atom(const Token& t, Term& result);
+  bool apply(Frame& f, Term& result);
+  bool sameWidth(const std::vector<Term>& args);
+
+  SmtReader&   _reader;
+  sword&       _solver;
+  Lexer        _lexer;
+  SymbolTable  _symbols;
+  std::vector<Term>  _values;   // per symbol: declaration or let binding
+  std::vector<std::pair<uint32_t, Term> > _shadowed;
+  std::vector<Frame> _frames;   // reused, _depth of them are live
+  unsigned     _depth;
+  PSignal      _true, _false;
+};
+
+bool SmtParser::parseBenchmark() {
+  Token name;
+  if (!expect(Token::LPAREN, "'(benchmark'")) return false;
+  if (!_lexer.next().is("benchmark")) return fail("expected 'benchmark'");
+  if ((name = _lexer.next()).type != Token::SYMBOL) return fail("expected benchmark name");
+
+  for (;;) {
+    Token t = _lexer.next();
+    if (t.type == Token::RPAREN)
+      return _lexer.next().type == Token::END || fail("text after the benchmark");
+    if (t.type != Token::SYMBOL || *t.begin != ':')
+      return fail("expected attribute");
+
+    if (t.is(":extrafuns") || t.is(":extrapreds")) {
+      if (!parseDeclarations(t.is(":extrapreds"))) return false;
+    } else if (t.is(":assumption") || t.is(":formula")) {
+      Term f;
+      if (!parseTerm(f)) return false;
+      if (f.width != 1) return fail("formula expected");
+      _solver.addAssertion(f.signal);
+      ++_reader._numAssertions;
+    } else if (t.is(":status")) {
+      Token s = _lexer.next();
+      if (s.type != Token::SYMBOL) return fail("expected status");
+      _reader._status = s.str();
+    } else if (!skipValue()) {
+      return false;
+    }
+  }
+}
+
+bool SmtParser::parseWidth(const Token& t, unsigned& width) {
+  const char* prefix = "BitVec[";
+  size_t n = std::strlen(prefix);
+  if (t.size() < n + 2 || std::memcmp(t.begin, prefix, n) || t.end[-1] != ']' ||
+      !parseUnsigned(t.begin + n, t.end - 1, width) || width == 0)
+    return fail("expected BitVec[width], arrays are not supported");
+  return true;
+}
+
+bool SmtParser::parseDeclarations(bool predicates) {
+  if (!expect(Token::LPAREN, "'('")) return false;
+  for (;;) {
+    Token t = _lexer.next();
+    if (t.type == Token::RPAREN) return true;
+    if (t.type != Token::LPAREN) return fail("expected declaration");
+    Token name = _lexer.next();
+    if (name.type != Token::SYMBOL) return fail("expected symbol");
+
+    unsigned width = 1;
+    if (!predicates && !parseWidth(_lexer.next(), width)) return false;
+    if (_lexer.next().type != Token::RPAREN)
+      return fail("function and predicate symbols with arguments are not supported");
+
+    uint32_t id = intern(name);
+    if (_values[id].signal || id < NUM_OPS)
+      return fail("redeclared symbol " + name.str());
+    Term v = { _solver.addVariable(width, name.str()), width };
+    _values[id] = v;
+    SmtReader::Variable var = { v.signal, width };
+    _reader._variables[name.str()] = var;
+  }
+}
+
+bool SmtParser::skipValue() {
+  Token t = _lexer.next();
+  if (t.type == Token::SYMBOL || t.type == Token::OTHER) return true;
+  if (t.type != Token::LPAREN) return fail("expected attribute value");
+  for (unsigned open = 1; open > 0; ) {
+    t = _lexer.next();
+    if (t.type == Token::LPAREN) ++open;
+    else if (t.type == Token::RPAREN) --open;
+    else if (t.type == Token::END || t.type == Token::ERROR) return fail("unbalanced parentheses");
+  }
+  return true;
+}
+
+bool SmtParser::parseHead(Frame& f) {
+  Token h = _lexer.next();
+  if (h.type != Token::SYMBOL) return fail("expected operator");
+  const char* bracket = (const char*)std::memchr(h.begin, '[', h.size());
+  Token name = h;
+  if (bracket) name.end = bracket;
+  uint32_t id = intern(name);
+  if (id >= NUM_OPS) return fail("unknown operator " + h.str());
+  f.op = id;
+  f.args.clear();
+  f.bound = true;
+
+  if (OPS[id].kind == INDEXED) {
+    // [k] or [i:j]
+    if (!bracket || h.end[-1] != ']') return fail("expected index in " + h.str());
+    const char* colon = (const char*)std::memchr(bracket, ':', h.end - bracket);
+    bool two = OPS[id].op == EXTRACT;
+    if ((colon != 0) != two ||
+        !parseUnsigned(bracket + 1, two ? colon : h.end - 1, f.index0) ||
+        (two && !parseUnsigned(colon + 1, h.end - 1, f.index1)))
+      return fail("malformed index in " + h.str());
+  } else if (bracket) {
+    return fail("unexpected index in " + h.str());
+  }
+
+  if (OPS[id].kind == BINDER) {
+    if (!expect(Token::LPAREN, "'(' of the binding")) return false;
+    Token var = _lexer.next();
+    if (var.type != Token::SYMBOL) return fail("expected variable");
+    f.var = intern(var);
+    f.bound = false;
+  }
+  return true;
+}
+
+bool SmtParser::parseTerm(Term& result) {
+  const unsigned base = _depth;
+  for (;;) {
+    Token t = _lexer.next();
+    Term value;
+    switch (t.type) {
+      case Token::LPAREN:
+        if (_depth == _frames.size())
+          _frames.push_back(Frame());
+        if (!parseHead(_frames[_depth++])) return false;
+        continue;
+
+      case Token::RPAREN: {
+        if (_depth == base) return fail("unexpected ')'");
+        Frame& f = _frames[_depth - 1];
+        if (!f.bound) {
+          // end of (var term): bind, the body follows
+          if (f.args.size() != 1) return fail("malformed binding");
+          _shadowed.push_back(std::make_pair(f.var, _values[f.var]));
+          _values[f.var] = f.args[0];
+          f.args.clear();
+          f.bound = true;
+          continue;
+        }
+        if (!apply(f, value)) return false;
+        if (OPS[f.op].kind == BINDER) {
+          _values[_shadowed.back().first] = _shadowed.back().second;
+          _shadowed.pop_back();
+        }
+        --_depth;
+        break;
+      }
+
+      case Token::SYMBOL:
+        if (!atom(t, value)) return false;
+        break;
+
+      case Token::END:
+        return fail("unexpected end of input");
+      default:
+        return fail("unexpected token " + t.str());
+    }
+
+    if (_depth == base) {
+      result = value;
+      return true;
+    }
+    _frames[_depth - 1].args.push_back(value);
+  }
+}
+
+bool SmtParser::atom(const Token& t, Term& result) {
+  if (t.is("true")  || t.is("bit1")) { result = constant(true);  return true; }
+  if (t.is("false") || t.is("bit0")) { result = constant(false); return true; }
+
+  if (t.size() > 2 && t.begin[0] == 'b' && t.begin[1] == 'v') {
+    const char* p = t.begin + 2;
+    if (t.size() > 5 && !std::memcmp(p, "bin", 3)) {
+      result.width = t.size() - 5;
+      result.signal = _solver.addBinConstant(std::string(p + 3, t.end));
+      return true;
+    }
+    if (t.size() > 5 && !std::memcmp(p, "hex", 3)) {
+      result.width = 4 * (t.size() - 5);
+      result.signal = _solver.addHexConstant(std::string(p + 3, t.end));
+      return true;
+    }
+    // bv<decimal>[width]
+    const char* bracket = (const char*)std::memchr(p, '[', t.end - p);
+    unsigned width;
+    if (bracket && bracket > p && t.end[-1] == ']' &&
+        parseUnsigned(bracket + 1, t.end - 1, width) && width > 0) {
+      std::string digits(p, bracket);
+      if (digits.find_first_not_of("0123456789") != std::string::npos)
+        return fail("malformed constant " + t.str());
+      result.width = width;
+      // the decimal string overload of addConstant loses bits, binary does not
+      errno = 0;
+      unsigned long long x = std::strtoull(digits.c_str(), 0, 10);
+      result.signal = errno != ERANGE && width <= 64
+        ? _solver.addConstant(width, (unsigned long)x)
+        : _solver.addBinConstant(width, decimalToBinary(digits, width));
+      return true;
+    }
+  }
+
+  uint32_t id = intern(t);
+  if (id < NUM_OPS || !_values[id].signal)
+    return fail("undeclared symbol " + t.str());
+  result = _values[id];
+  return true;
+}
+
+bool SmtParser::sameWidth(const std::vector<Term>& args) {
+  for (unsigned i = 1; i < args.size(); ++i)
+    if (args[i].width != args[0].width)
+      return fail("operands of different width");
+  return true;
+}
+
+bool SmtParser::apply(Frame& f, Term& result) {
+  const OpInfo& info = OPS[f.op];
+  std::vector<Term>& args = f.args;
+  if (args.empty())
+    return fail(std::string("missing operands of ") + info.name);
+
+  switch (info.kind) {
+    case BINDER:
+      if (args.size() != 1) return fail("malformed let");
+      result = args[0];
+      return true;
+
+    case CONNECTIVE:
+      if (!sameWidth(args)) return false;
+      result = args[0];
+      if (args.size() > 2 && info.op != XOR) {
+        std::vector<PSignal> signals;
+        for (unsigned i = 0; i < args.size(); ++i)
+          signals.push_back(args[i].signal);
+        result.signal = _solver.addOperator(info.op, &signals);
+        return true;
+      }
+      for (unsigned i = 1; i < args.size(); ++i)
+        result.signal = _solver.addOperator(info.op, result.signal, args[i].signal);
+      return true;
+
+    case PREDICATE: {
+      if (!sameWidth(args)) return false;
+      bool unary = info.op == RED_OR || info.op == RED_AND;
+      if (unary ? args.size() != 1 : args.size() < 2 || (args.size() > 2 && info.op != EQUAL && info.op != NEQUAL))
+        return fail(std::string("wrong number of operands of ") + info.name);
+      result.width = 1;
+      if (unary || args.size() == 2) {
+        result.signal = _solver.addOperator(info.op, args[0].signal, args.size() > 1 ? args[1].signal : PSignal());
+      } else if (info.op == NEQUAL) {
+        // pairwise, the bit-blaster has no DISTINCT
+        std::vector<PSignal> pairs;
+        for (unsigned i = 0; i < args.size(); ++i)
+          for (unsigned j = i + 1; j < args.size(); ++j)
+            pairs.push_back(_solver.addOperator(NEQUAL, args[i].signal, args[j].signal));
+        result.signal = _solver.addOperator(AND, &pairs);
+      } else {
+        // chained equality
+        std::vector<PSignal> pairs;
+        for (unsigned i = 0; i + 1 < args.size(); ++i)
+          pairs.push_back(_solver.addOperator(EQUAL, args[i].signal, args[i+1].signal));
+        result.signal = _solver.addOperator(AND, &pairs);
+      }
+      return true;
+    }
+
+    case FUNCTION: {
+      if (!sameWidth(args)) return false;
+      bool unary = info.op == NOT || info.op == NEG;
+      if (unary ? args.size() != 1 : args.size() < 2)
+        return fail(std::string("wrong number of operands of ") + info.name);
+      result = args[0];
+      if (unary)
+        result.signal = _solver.addOperator(info.op, args[0].signal);
+      for (unsigned i = 1; i < args.size(); ++i)
+        result.signal = _solver.addOperator(info.op, result.signal, args[i].signal);
+      return true;
+    }
+
+    case CONCATENATE:
+      result = args[0];
+      for (unsigned i = 1; i < args.size(); ++i) {
+        result.signal = _solver.addOperator(CONCAT, result.signal, args[i].signal);
+        result.width += args[i].width;
+      }
+      return true;
+
+    case IF_THEN_ELSE:
+      if (args.size() != 3 || args[0].width != 1 || args[1].width != args[2].width)
+        return fail("malformed if-then-else");
+      result.width = args[1].width;
+      result.signal = _solver.addOperator(ITE, args[0].signal, args[1].signal, args[2].signal);
+      return true;
+
+    case INDEXED: {
+      if (args.size() != 1)
+        return fail(std::string("wrong number of operands of ") + info.name);
+      const Term& a = args[0];
+      unsigned k = f.index0;
+      result = a;
+      switch (info.op) {
+        case EXTRACT:
+          if (k >= a.width || f.index1 > k) return fail("extract out of range");
+          result.width = k - f.index1 + 1;
+          result.signal = _solver.addExtract(a.signal, k, f.index1);
+          break;
+        case ZERO_EXTEND:
+        case SIGN_EXTEND:
+          if (k == 0) break;
+          result.width = a.width + k;
+          result.signal = info.op == ZERO_EXTEND ? _solver.addZeroExtend(a.signal, k)
+                                                 : _solver.addSignExtend(a.signal, k);
+          break;
+        case REPEAT:
+          if (k == 0) return fail("repeat[0]");
+          if (k == 1) break;
+          result.width = a.width * k;
+          result.signal = _solver.addRepeat(a.signal, k);
+          break;
+        default:
+          k %= a.width;
+          if (k == 0) break;
+          result.signal = info.op == ROTATE_LEFT ? _solver.addRotateLeft(a.signal, k)
+                                                 : _solver.addRotateRight(a.signal, k);
+          break;
+      }
+      return true;
+    }
+  }
+  return fail("unsupported operator");
+}
+
+
+SmtReader::SmtReader(sword& solver)
+  : _solver(solver)
+  , _numAssertions(0)
+{ }
+
+bool SmtReader::parse(const char* first, const char* last) {
+  _error.clear();
+  SmtParser parser(*this, first, last);
+  return parser.parseBenchmark();
+}
+
+bool SmtReader::parseFile(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    _error = "cannot open " + path;
+    return false;
+  }
+  struct stat st;
+  if (::fstat(fd, &st) < 0 || st.st_size == 0) {
+    ::close(fd);
+    _error = "cannot read " + path;
+    return false;
+  }
+  void* data = ::mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    _error = "cannot map " + path;
+    return false;
+  }
+  ::madvise(data, st.st_size, MADV_SEQUENTIAL);
+  const char* text = (const char*)data;
+  bool ok = parse(text, text + st.st_size);
+  ::munmap(data, st.st_size);
+  return ok;
+}
+
+Signal* SmtReader::variable(const std::string& name) const {
+  std::unordered_map<std::string, Variable>::const_iterator it = _variables.find(name);
+  return it == _variables.end() ? 0 : it->second.signal;
+}
+
+} /* namespace rsynth */
@@ -0,0 +1,168 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "Sweep.h"
+#include "AigToSword.h"
+#include "Random.h"
+
+#include "libsword.h"
+
+#include <memory>
+#include <unordered_map>
+
+using namespace SWORD;
+
+namespace rsynth {
+
+namespace {
+
+// the solver is rebuilt once this many nodes have been lowered into it,
+// sword re-processes the whole instance on every solve
+const unsigned RESET_LIMIT = 20000;
+
+/**
+ * simulation signatures, normalised so that bit 0 of the random part is 0;
+ * the phase records whether the node was complemented to get there
+ */
+class Signatures {
+public:
+  Signatures(const Aig& aig, unsigned words)
+    : _aig(aig), _words(words), _numCex(0)
+    , _random(aig.numNodes() * words), _phase(aig.numNodes())
+  {
+    uint64_t seed = 0x9e3779b97f4a7c15ull;
+    std::vector<uint64_t> in(aig.numInputs());
+    for (unsigned w = 0; w < words; ++w) {
+      for (unsigned i = 0; i < in.size(); ++i)
+        in[i] = xorshift(seed);
+      std::vector<uint64_t> values = aig.simulate(in);
+      for (uint32_t n = 0; n < values.size(); ++n)
+        _random[n * words + w] = values[n];
+    }
+    for (uint32_t n = 0; n < aig.numNodes(); ++n) {
+      _phase[n] = _random[n * words] & 1;
+      if (_phase[n])
+        for (unsigned w = 0; w < words; ++w)
+          _random[n * words + w] = ~_random[n * words + w];
+    }
+  }
+
+  bool phase(uint32_t n) const { return _phase[n]; }
+
+  uint64_t hash(uint32_t n) const {
+    uint64_t h = 0;
+    for (unsigned w = 0; w < _words; ++w)
+      h = (h ^ _random[n * _words + w]) * 0x100000001b3ull;
+    return h;
+  }
+
+  bool equal(uint32_t n, uint32_t m) const {
+    for (unsigned w = 0; w < _words; ++w)
+      if (_random[n * _words + w] != _random[m * _words + w])
+        return false;
+    for (unsigned w = 0; w < _cex.size(); ++w)
+      if (_cex[w][n] != _cex[w][m])
+        return false;
+    return true;
+  }
+
+  /**
+   * adds one input pattern, i.e. one more bit to every signature
+   */
+  void addPattern(const std::vector<bool>& inputs) {
+    if (_numCex % 64 == 0)
+      _cex.push_back(std::vector<uint64_t>(_aig.numNodes(), 0));
+    std::vector<uint64_t> in(inputs.size());
+    for (unsigned i = 0; i < in.size(); ++i)
+      in[i] = inputs[i] ? ~0ull : 0ull;
+    std::vector<uint64_t> values = _aig.simulate(in);
+    std::vector<uint64_t>& word = _cex.back();
+    uint64_t bit = 1ull << (_numCex % 64);
+    for (uint32_t n = 0; n < values.size(); ++n)
+      if ((values[n] & 1) != (uint64_t)_phase[n])
+        word[n] |= bit;
+    ++_numCex;
+  }
+
+private:
+  const Aig& _aig;
+  unsigned   _words;
+  unsigned   _numCex;
+  std::vector<uint64_t> _random;
+  std::vector<bool>     _phase;
+  std::vector<std::vector<uint64_t> > _cex;
+};
+
+} /* namespace */
+
+Aig sweep(const Aig& aig, std::vector<AigLit>& map, SweepStats* stats, unsigned words, unsigned maxChecks) {
+  SweepStats local;
+  SweepStats& st = stats ? *stats : local;
+  Signatures sigs(aig, words);
+
+  Aig result;
+  map.assign(aig.numNodes(), aig_Undef);
+  map[0] = aig_False;
+  for (unsigned i = 0; i < aig.numInputs(); ++i)
+    map[aig.inputs()[i]] = result.addInput(aig.inputName(i));
+
+  // members of each candidate class that were kept as they are
+  std::unordered_map<uint64_t, std::vector<uint32_t> > classes;
+  classes[sigs.hash(0)].push_back(0);
+  for (unsigned i = 0; i < aig.numInputs(); ++i)
+    classes[sigs.hash(aig.inputs()[i])].push_back(aig.inputs()[i]);
+
+  std::unique_ptr<sword> solver;
+  std::unique_ptr<AigToSword> lower;
+
+  for (uint32_t n = 1; n < aig.numNodes(); ++n) {
+    if (aig.type(n) != Aig::AND && aig.type(n) != Aig::XOR)
+      continue;
+    AigLit a = map[node(aig.fanin0(n))] ^ sign(aig.fanin0(n));
+    AigLit b = map[node(aig.fanin1(n))] ^ sign(aig.fanin1(n));
+    AigLit l = aig.type(n) == Aig::AND ? result.addAnd(a, b) : result.addXor(a, b);
+    map[n] = l;
+
+    std::vector<uint32_t>& members = classes[sigs.hash(n)];
+    bool merged = false;
+    unsigned checks = 0;
+    for (unsigned i = 0; i < members.size() && !merged; ++i) {
+      uint32_t c = members[i];
+      if (!sigs.equal(n, c))
+        continue;
+      AigLit target = map[c] ^ (sigs.phase(n) != sigs.phase(c));
+      if (l == target) {
+        merged = true;
+        break;
+      }
+      if (checks++ == maxChecks)
+        break;
+
+      if (!solver || lower->numLowered() > RESET_LIMIT) {
+        lower.reset();
+        solver.reset(new sword());
+        lower.reset(new AigToSword(result, *solver));
+      }
+      PSignal miter = solver->addOperator(XOR, lower->signal(l), lower->signal(target));
+      solver->addAssumption(miter);
+      ++st.checks;
+      if (!solver->solve()) {
+        ++st.proved;
+        solver->addAssertion(miter, false);
+        map[n] = target;
+        merged = true;
+      } else {
+        ++st.disproved;
+        std::vector<bool> cex(aig.numInputs());
+        for (unsigned j = 0; j < cex.size(); ++j)
+          cex[j] = lower->inputValue(j);
+        sigs.addPattern(cex);
+      }
+    }
+    if (merged)
+      ++st.merged;
+    else
+      members.push_back(n);
+  }
+  return result;
+}
+
+} /* namespace rsynth */
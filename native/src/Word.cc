@@ -0,0 +1,226 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "Word.h"
+
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+#include <unordered_map>
+
+namespace rsynth {
+
+namespace {
+
+/**
+ * multiplexer trees over sub-tables of a ROM, one shared table of trees
+ * keyed by sub-table contents ('0'/'1' per entry)
+ */
+class RomBuilder {
+public:
+  RomBuilder(Aig& aig, const Word& index) : _aig(aig), _index(index) { }
+
+  AigLit build(const std::string& bits) { return build(bits, _index.size()); }
+
+private:
+  AigLit build(const std::string& bits, unsigned level) {
+    if (bits.find('1') == std::string::npos) return aig_False;
+    if (bits.find('0') == std::string::npos) return aig_True;
+    std::unordered_map<std::string, AigLit>::const_iterator it = _memo.find(bits);
+    if (it != _memo.end())
+      return it->second;
+
+    size_t half = bits.size() / 2;
+    AigLit lo = build(bits.substr(0, half), level - 1);
+    AigLit hi = build(bits.substr(half), level - 1);
+    AigLit l = _aig.addIte(_index[level - 1], hi, lo);
+    _memo[bits] = l;
+    return l;
+  }
+
+  Aig& _aig;
+  const Word& _index;
+  std::unordered_map<std::string, AigLit> _memo;
+};
+
+} /* namespace */
+
+Word addWord(Aig& aig, unsigned width, const std::string& name) {
+  Word w;
+  for (unsigned i = 0; i < width; ++i) {
+    std::ostringstream s;
+    s << name << "[" << i << "]";
+    w.push_back(aig.addInput(s.str()));
+  }
+  return w;
+}
+
+Word constWord(uint64_t value, unsigned width) {
+  Word w;
+  for (unsigned i = 0; i < width; ++i)
+    w.push_back(i < 64 && (value >> i) & 1 ? aig_True : aig_False);
+  return w;
+}
+
+Word addIte(Aig& aig, AigLit s, const Word& t, const Word& e) {
+  assert(t.size() == e.size());
+  Word w;
+  for (unsigned i = 0; i < t.size(); ++i)
+    w.push_back(aig.addIte(s, t[i], e[i]));
+  return w;
+}
+
+AigLit addEqual(Aig& aig, const Word& s, const Word& t) {
+  assert(s.size() == t.size());
+  std::vector<AigLit> eq;
+  for (unsigned i = 0; i < s.size(); ++i)
+    eq.push_back(aig.addIff(s[i], t[i]));
+  return aig.addAnd(eq);
+}
+
+Word addSelect(Aig& aig, const Word& index, const std::vector<uint64_t>& table, unsigned width) {
+  assert(index.size() < 32);
+  size_t size = (size_t)1 << index.size();
+  RomBuilder rom(aig, index);
+  Word w;
+  std::string bits(size, '0');
+  for (unsigned b = 0; b < width; ++b) {
+    for (size_t j = 0; j < size; ++j)
+      bits[j] = j < table.size() && b < 64 && (table[j] >> b) & 1 ? '1' : '0';
+    w.push_back(rom.build(bits));
+  }
+  return w;
+}
+
+std::vector<AigLit> addDecoder(Aig& aig, const Word& index, unsigned n) {
+  if (index.size() < 32 && n > (1u << index.size())) {
+    // lines the index cannot reach
+    std::vector<AigLit> lines = addDecoder(aig, index, 1u << index.size());
+    lines.resize(n, aig_False);
+    return lines;
+  }
+  if (index.empty())
+    return std::vector<AigLit>(n > 0 ? 1 : 0, aig_True);
+  if (index.size() == 1) {
+    std::vector<AigLit> lines;
+    lines.push_back(~index[0]);
+    if (n > 1) lines.push_back(index[0]);
+    lines.resize(n < 2 ? n : 2);
+    return lines;
+  }
+
+  // lines = high x low, low half covers index bits [0, k)
+  unsigned k = index.size() / 2;
+  unsigned lowLines = std::min(n, 1u << k);
+  std::vector<AigLit> low  = addDecoder(aig, Word(index.begin(), index.begin() + k), lowLines);
+  std::vector<AigLit> high = addDecoder(aig, Word(index.begin() + k, index.end()),
+                                        (n + lowLines - 1) / lowLines);
+  std::vector<AigLit> lines;
+  for (unsigned i = 0; i < n; ++i)
+    lines.push_back(aig.addAnd(high[i / lowLines], low[i % lowLines]));
+  return lines;
+}
+
+AigLit addBitSelect(Aig& aig, const Word& s, const Word& idx) {
+  std::vector<AigLit> lines = addDecoder(aig, idx, s.size());
+  std::vector<AigLit> terms;
+  for (unsigned i = 0; i < s.size(); ++i)
+    terms.push_back(aig.addAnd(lines[i], s[i]));
+  return aig.addOr(terms);
+}
+
+Word addBitUpdate(Aig& aig, const Word& s, const Word& idx, AigLit v) {
+  std::vector<AigLit> lines = addDecoder(aig, idx, s.size());
+  Word w;
+  for (unsigned i = 0; i < s.size(); ++i)
+    w.push_back(aig.addIte(lines[i], v, s[i]));
+  return w;
+}
+
+Word addBitFlip(Aig& aig, const Word& s, const Word& idx, AigLit f) {
+  std::vector<AigLit> lines = addDecoder(aig, idx, s.size());
+  Word w;
+  for (unsigned i = 0; i < s.size(); ++i)
+    w.push_back(aig.addXor(s[i], aig.addAnd(lines[i], f)));
+  return w;
+}
+
+Word addPopCount(Aig& aig, const std::vector<AigLit>& bits) {
+  unsigned width = 0;
+  while (((size_t)1 << width) <= bits.size())
+    ++width;
+
+  // columns[w] holds the bits of weight 2^w that are still to be added
+  std::vector<std::vector<AigLit> > columns(width + 1);
+  columns[0] = bits;
+  Word count;
+  for (unsigned w = 0; w < width; ++w) {
+    std::vector<AigLit>& col = columns[w];
+    while (col.size() > 1) {
+      AigLit a = col.back(); col.pop_back();
+      AigLit b = col.back(); col.pop_back();
+      AigLit ab = aig.addXor(a, b);
+      if (col.empty()) {
+        col.push_back(ab);
+        columns[w + 1].push_back(aig.addAnd(a, b));
+        break;
+      }
+      AigLit c = col.back(); col.pop_back();
+      // full adder: the carry is the majority of a, b, c
+      col.insert(col.begin(), aig.addXor(ab, c));
+      columns[w + 1].push_back(aig.addOr(aig.addAnd(a, b), aig.addAnd(ab, c)));
+    }
+    count.push_back(col.empty() ? aig_False : col[0]);
+  }
+  return count;
+}
+
+Word addHamming(Aig& aig, const Word& a, const Word& b) {
+  assert(a.size() == b.size());
+  std::vector<AigLit> diff;
+  for (unsigned i = 0; i < a.size(); ++i)
+    diff.push_back(aig.addXor(a[i], b[i]));
+  return addPopCount(aig, diff);
+}
+
+namespace {
+
+std::vector<AigLit> totalize(Aig& aig, const AigLit* first, const AigLit* last, unsigned bound) {
+  size_t n = last - first;
+  if (n == 1)
+    return std::vector<AigLit>(1, *first);
+
+  std::vector<AigLit> a = totalize(aig, first, first + n / 2, bound);
+  std::vector<AigLit> b = totalize(aig, first + n / 2, last, bound);
+  // more than k true iff, for some i, more than i-1 in a and k-i in b
+  unsigned size = std::min<size_t>(n, bound);
+  std::vector<AigLit> out;
+  for (unsigned k = 0; k < size; ++k) {
+    std::vector<AigLit> terms;
+    for (unsigned i = 0; i <= k + 1; ++i) {
+      unsigned j = k + 1 - i;
+      if (i > a.size() || j > b.size()) continue;
+      AigLit ai = i == 0 ? aig_True : a[i - 1];
+      AigLit bj = j == 0 ? aig_True : b[j - 1];
+      terms.push_back(aig.addAnd(ai, bj));
+    }
+    out.push_back(aig.addOr(terms));
+  }
+  return out;
+}
+
+} /* namespace */
+
+std::vector<AigLit> addUnaryCount(Aig& aig, const std::vector<AigLit>& bits, unsigned bound) {
+  if (bits.empty() || bound == 0)
+    return std::vector<AigLit>(bound, aig_False);
+  std::vector<AigLit> out = totalize(aig, bits.data(), bits.data() + bits.size(), bound);
+  out.resize(bound, aig_False);
+  return out;
+}
+
+AigLit addAtMost(Aig& aig, const std::vector<AigLit>& bits, unsigned k) {
+  if (k >= bits.size())
+    return aig_True;
+  return ~addUnaryCount(aig, bits, k + 1)[k];
+}
+
+} /* namespace rsynth */
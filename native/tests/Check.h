@@ -0,0 +1,19 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#ifndef RSYNTH__TESTS_CHECK_H
+#define RSYNTH__TESTS_CHECK_H
+
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * aborts the test program with the failed condition and its location
+ */
+#define CHECK(cond)                                                         \
+  do {                                                                      \
+    if (!(cond)) {                                                          \
+      std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      std::exit(1);                                                         \
+    }                                                                       \
+  } while (0)
+
+#endif /* RSYNTH__TESTS_CHECK_H */
@@ -0,0 +1,72 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "Batch.h"
+#include "Cascade.h"
+#include "Check.h"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace rsynth;
+
+namespace {
+
+/**
+ * random targets of up to maxGates gates, the number of gates used in gatesUsed
+ */
+std::vector<std::vector<unsigned> > randomTargets(unsigned width, unsigned count, unsigned maxGates,
+                                                  std::vector<unsigned>& gatesUsed) {
+  std::vector<Gate> gates = allGates(width);
+  std::vector<std::vector<unsigned> > targets;
+  for (unsigned n = 0; n < count; ++n) {
+    std::vector<unsigned> circuit;
+    for (unsigned p = n % (maxGates + 1); p > 0; --p)
+      circuit.push_back(std::rand() % gates.size());
+    targets.push_back(simulate(width, gates, circuit));
+    gatesUsed.push_back(circuit.size());
+  }
+  return targets;
+}
+
+void testSolveBatch() {
+  // more threads than some workers get targets, results in input order
+  std::vector<Gate> gates = allGates(3);
+  std::vector<unsigned> used;
+  std::vector<std::vector<unsigned> > targets = randomTargets(3, 40, 3, used);
+  for (unsigned threads = 1; threads <= 3; ++threads) {
+    std::vector<BatchResult> results = solveBatch(3, 2, targets, threads);
+    CHECK(results.size() == targets.size());
+    for (unsigned n = 0; n < targets.size(); ++n) {
+      if (used[n] <= 2 && used[n] % 2 == 0)
+        CHECK(results[n].found);   // G G is the identity
+      if (results[n].found)
+        CHECK(results[n].circuit.size() == 2 && simulate(3, gates, results[n].circuit) == targets[n]);
+    }
+  }
+  CHECK(solveBatch(3, 2, std::vector<std::vector<unsigned> >(), 4).empty());
+}
+
+void testSynthesizeBatch() {
+  std::vector<Gate> gates = allGates(4);
+  std::vector<unsigned> used;
+  std::vector<std::vector<unsigned> > targets = randomTargets(4, 12, 4, used);
+  std::vector<BatchResult> results = synthesizeBatch(4, 4, targets, 2);
+  for (unsigned n = 0; n < targets.size(); ++n) {
+    CHECK(results[n].found);
+    CHECK(results[n].circuit.size() <= used[n]);
+    CHECK(simulate(4, gates, results[n].circuit) == targets[n]);
+  }
+  // the same targets one by one give the same optimal lengths
+  for (unsigned n = 0; n < targets.size(); n += 3) {
+    std::vector<std::vector<unsigned> > one(1, targets[n]);
+    CHECK(synthesizeBatch(4, 4, one, 1, true)[0].circuit.size() == results[n].circuit.size());
+  }
+}
+
+} /* namespace */
+
+int main() {
+  std::srand(1);
+  testSolveBatch();
+  testSynthesizeBatch();
+  return 0;
+}
@@ -0,0 +1,82 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "Cascade.h"
+#include "Check.h"
+
+#include "libsword.h"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace rsynth;
+
+namespace {
+
+void testGates() {
+  std::vector<Gate> gates = allGates(4);
+  CHECK(gates.size() == 4 * 3 * 2);
+  CHECK(gates[0].t == 0 && gates[0].c1 == 1 && gates[0].c2 == 2);
+  // G(0, 1, 2) flips bit 0 unless c1 = 0 and c2 = 1
+  CHECK(apply(gates[0], 0) == 1 && apply(gates[0], 4) == 4 && apply(gates[0], 6) == 7);
+}
+
+void testSimulate() {
+  // 7 rows short of a word, and two words
+  for (unsigned width = 6; width <= 7; ++width) {
+    std::vector<Gate> gates = allGates(width);
+    std::vector<unsigned> circuit;
+    for (unsigned p = 0; p < 9; ++p)
+      circuit.push_back(std::rand() % gates.size());
+    CHECK(simulateTable(width, gates, circuit) == truthTable(width, simulate(width, gates, circuit)));
+  }
+  std::vector<Gate> gates = allGates(3);
+  CHECK(simulateTable(3, gates, std::vector<unsigned>())[1][0] == 0xcc);
+}
+
+void testReuse() {
+  // one instance answers a run of targets, satisfiable or not
+  SWORD::sword solver;
+  CascadeEncoding enc(solver, 3, 2);
+  std::vector<Gate> gates = enc.gates();
+  for (unsigned round = 0; round < 20; ++round) {
+    std::vector<unsigned> circuit(2);
+    circuit[0] = std::rand() % gates.size();
+    circuit[1] = std::rand() % gates.size();
+    std::vector<unsigned> target = simulate(3, gates, circuit);
+    CHECK(enc.solve(target));
+    CHECK(simulate(3, gates, enc.circuit()) == target);
+
+    // whatever the answer for a nearby target, it must not leak into the next
+    std::vector<unsigned> swapped = target;
+    std::swap(swapped[0], swapped[1]);
+    CHECK(!enc.solve(swapped) || simulate(3, gates, enc.circuit()) == swapped);
+  }
+}
+
+void testUnsat() {
+  SWORD::sword solver;
+  CascadeEncoding one(solver, 3, 1);
+  std::vector<unsigned> identity(8);
+  for (unsigned row = 0; row < 8; ++row)
+    identity[row] = row;
+  CHECK(!one.solve(identity));
+  std::vector<unsigned> circuit(1, 5);
+  std::vector<unsigned> target = simulate(3, one.gates(), circuit);
+  CHECK(one.solve(target) && one.circuit() == circuit);
+
+  SWORD::sword empty;
+  CascadeEncoding none(empty, 3, 0);
+  CHECK(none.solve(identity) && none.circuit().empty());
+  CHECK(!none.solve(target));
+  CHECK(none.solve(identity));
+}
+
+} /* namespace */
+
+int main() {
+  std::srand(1);
+  testGates();
+  testSimulate();
+  testReuse();
+  testUnsat();
+  return 0;
+}
@@ -0,0 +1,78 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "Check.h"
+
+#include "SolverTypes.h"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace SWORD;
+
+namespace {
+
+/**
+ * a malloc'ed clause over the given DIMACS style literals
+ */
+Clause* clause(int a, int b, int c = 0, int d = 0) {
+  const int in[] = { a, b, c, d };
+  std::vector<Lit> ps;
+  for (unsigned i = 0; i < 4 && in[i]; ++i)
+    ps.push_back(Lit(std::abs(in[i]), in[i] < 0));
+  return Clause_new(ps);
+}
+
+void testSubsumes() {
+  Clause* ab   = clause(1, 2);
+  Clause* abc  = clause(1, 2, 3);
+  Clause* anbc = clause(1, -2, 3);
+  Clause* cd   = clause(3, 4);
+
+  CHECK(ab->subsumes(*abc) == lit_Undef);
+  CHECK(abc->subsumes(*ab) == lit_Error);   // longer than other
+  CHECK(cd->subsumes(*abc) == lit_Error);   // 4 is missing
+  // (1 2) and (1 -2 3) resolve on 2 to (1 3)
+  CHECK(ab->subsumes(*anbc) == Lit(2));
+
+  std::free(ab);
+  std::free(abc);
+  std::free(anbc);
+  std::free(cd);
+}
+
+void testStrengthen() {
+  Clause* ab   = clause(1, 2);
+  Clause* anbc = clause(1, -2, 35);   // 35 and 3 share an abstraction bit
+  uint32_t before = anbc->abstraction();
+  CHECK(before == ((1u << 1) | (1u << 2) | (1u << 3)));
+
+  Lit q = ab->subsumes(*anbc);
+  anbc->strengthen(~q);
+  CHECK(anbc->size() == 2);
+  CHECK((*anbc)[0] == Lit(1) && (*anbc)[1] == Lit(35));   // order is kept
+  CHECK(anbc->abstraction() == ((1u << 1) | (1u << 3)));
+
+  // strengthened, (1 35) is subsumed by (1 35) and no longer by (1 2)
+  Clause* a35 = clause(1, 35);
+  CHECK(a35->subsumes(*anbc) == lit_Undef);
+  CHECK(ab->subsumes(*anbc) == lit_Error);
+
+  // removing the first and the last literal
+  Clause* abcd = clause(1, 2, 3, 4);
+  abcd->strengthen(Lit(1));
+  abcd->strengthen(Lit(4));
+  CHECK(abcd->size() == 2 && (*abcd)[0] == Lit(2) && (*abcd)[1] == Lit(3));
+  CHECK(abcd->abstraction() == ((1u << 2) | (1u << 3)));
+
+  std::free(ab);
+  std::free(anbc);
+  std::free(a35);
+  std::free(abcd);
+}
+
+} /* namespace */
+
+int main() {
+  testSubsumes();
+  testStrengthen();
+  return 0;
+}
@@ -0,0 +1,210 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "Aig.h"
+#include "Cnf.h"
+#include "Check.h"
+
+#include "libsword.h"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace rsynth;
+
+namespace {
+
+/**
+ * brute force: is cnf satisfiable with the given variables fixed
+ */
+bool satisfiable(const Cnf& cnf, std::vector<int> fixed) {
+  std::vector<int> free_;
+  std::vector<int> value(cnf.numVars + 1, 0);
+  for (unsigned i = 0; i < fixed.size(); ++i) {
+    int v = std::abs(fixed[i]), b = fixed[i] > 0 ? 1 : -1;
+    if (value[v] == -b) return false;
+    value[v] = b;
+  }
+  for (int v = 1; v <= cnf.numVars; ++v)
+    if (value[v] == 0) free_.push_back(v);
+  CHECK(free_.size() <= 20);
+
+  for (unsigned long m = 0; m < (1ul << free_.size()); ++m) {
+    for (unsigned i = 0; i < free_.size(); ++i)
+      value[free_[i]] = (m >> i) & 1 ? 1 : -1;
+    bool ok = true;
+    for (unsigned c = 0; ok && c < cnf.numClauses(); ++c) {
+      bool sat = false;
+      for (const int* l = cnf.begin(c); !sat && l != cnf.end(c); ++l)
+        sat = value[std::abs(*l)] == (*l > 0 ? 1 : -1);
+      ok = sat;
+    }
+    if (ok) return true;
+  }
+  return false;
+}
+
+AigLit randomCircuit(Aig& aig, const std::vector<AigLit>& inputs, unsigned size) {
+  std::vector<AigLit> pool(inputs);
+  for (unsigned i = 0; i < size; ++i) {
+    AigLit a = pool[std::rand() % pool.size()] ^ (std::rand() & 1);
+    AigLit b = pool[std::rand() % pool.size()] ^ (std::rand() & 1);
+    AigLit c = pool[std::rand() % pool.size()] ^ (std::rand() & 1);
+    switch (std::rand() % 4) {
+      case 0: pool.push_back(aig.addAnd(a, b)); break;
+      case 1: pool.push_back(aig.addOr(a, b)); break;
+      case 2: pool.push_back(aig.addXor(a, b)); break;
+      case 3: pool.push_back(aig.addIte(a, b, c)); break;
+    }
+  }
+  return pool.back();
+}
+
+bool eval(const Aig& aig, AigLit root, unsigned assignment) {
+  std::vector<uint64_t> in(aig.numInputs());
+  for (unsigned i = 0; i < in.size(); ++i)
+    in[i] = (assignment >> i) & 1 ? ~0ull : 0ull;
+  return Aig::value(aig.simulate(in), root) & 1;
+}
+
+std::vector<int> inputUnits(CnfEncoder& enc, unsigned assignment, unsigned numInputs) {
+  std::vector<int> units;
+  for (unsigned i = 0; i < numInputs; ++i)
+    units.push_back((assignment >> i) & 1 ? enc.inputVar(i) : -enc.inputVar(i));
+  return units;
+}
+
+void testAigSimplification() {
+  Aig aig;
+  AigLit a = aig.addInput("a"), b = aig.addInput("b");
+  CHECK(aig.addAnd(a, ~a) == aig_False);
+  CHECK(aig.addAnd(a, a) == a);
+  CHECK(aig.addAnd(a, b) == aig.addAnd(b, a));
+  CHECK(aig.addXor(~a, b) == ~aig.addXor(a, b));
+  CHECK(aig.addXor(a, a) == aig_False);
+  CHECK(aig.addIte(a, ~b, b) == aig.addXor(a, b));
+  CHECK(aig.numAnds() == 1 && aig.numXors() == 1);
+
+  AigLit c = aig.addInput("c");
+  AigLit m = aig.addIte(a, b, c), s, t, e;
+  // the mux is the complemented output of an AND node
+  CHECK(sign(m) && aig.isMux(node(m), s, t, e));
+  CHECK(s == a || s == ~a);
+  CHECK(s == a ? (t == ~b && e == ~c) : (t == ~c && e == ~b));
+}
+
+void testRewriteRules() {
+  Aig aig;
+  AigLit a = aig.addInput("a"), b = aig.addInput("b"), c = aig.addInput("c");
+  AigLit ab = aig.addAnd(a, b);
+  CHECK(aig.addAnd(ab, ~a) == aig_False);
+  CHECK(aig.addAnd(ab, a) == ab);
+  CHECK(aig.addAnd(a, aig.addOr(a, c)) == a);
+  CHECK(aig.addAnd(a, ~ab) == aig.addAnd(a, ~b));
+
+  AigLit t = aig.addXor(a, aig.addOr(b, ~c));
+  CHECK(aig.addXor(t, aig.addOr(b, ~c)) == a);
+  CHECK(aig.addXor(~aig.addOr(b, ~c), t) == ~a);
+
+  // (a ^ f) ^ g ^ ~f == ~(a ^ g), f is too deep for the binary rule
+  AigLit f = aig.addOr(b, ~c), g = aig.addOr(a, ~b);
+  AigLit chain = aig.addXor(aig.addXor(t, g), ~f);
+  CHECK(node(chain) != node(aig.addXor(a, g)));
+  std::vector<AigLit> lits(1, chain);
+  CHECK(aig.addXor(lits) == ~aig.addXor(a, g));
+
+  for (unsigned round = 0; round < 40; ++round) {
+    std::vector<AigLit> inputs;
+    for (unsigned i = 0; i < 4; ++i)
+      inputs.push_back(aig.addInput());
+    std::vector<AigLit> terms;
+    for (unsigned i = 0; i < 6; ++i)
+      terms.push_back(randomCircuit(aig, inputs, 3));
+    AigLit flat = aig.addXor(terms), nested = aig_False;
+    for (unsigned i = 0; i < terms.size(); ++i)
+      nested = aig.addXor(nested, terms[i]);
+
+    std::vector<uint64_t> in(aig.numInputs());
+    for (unsigned i = 0; i < in.size(); ++i)
+      in[i] = ((uint64_t)std::rand() << 32) ^ std::rand();
+    std::vector<uint64_t> values = aig.simulate(in);
+    CHECK(Aig::value(values, flat) == Aig::value(values, nested));
+  }
+}
+
+void testEquisatisfiable() {
+  for (unsigned round = 0; round < 40; ++round) {
+    Aig aig;
+    std::vector<AigLit> inputs;
+    for (unsigned i = 0; i < 4; ++i)
+      inputs.push_back(aig.addInput());
+    AigLit root = randomCircuit(aig, inputs, 8);
+
+    for (unsigned mode = 0; mode < 3; ++mode) {
+      CnfEncoder enc(aig, mode > 0, mode > 1);
+      enc.assertLit(root);
+      for (unsigned x = 0; x < 16; ++x)
+        CHECK(satisfiable(enc.cnf(), inputUnits(enc, x, 4)) == eval(aig, root, x));
+
+      // a defined literal is equivalent in both directions
+      CnfEncoder def(aig, mode > 0, mode > 1);
+      int d = def.defineLit(root);
+      for (unsigned x = 0; x < 16; ++x) {
+        std::vector<int> units = inputUnits(def, x, 4);
+        units.push_back(eval(aig, root, x) ? -d : d);
+        CHECK(!satisfiable(def.cnf(), units));
+      }
+    }
+  }
+}
+
+void testPolarityIsSmaller() {
+  Aig aig;
+  std::vector<AigLit> inputs;
+  for (unsigned i = 0; i < 6; ++i)
+    inputs.push_back(aig.addInput());
+  std::vector<AigLit> terms;
+  for (unsigned i = 0; i + 2 < inputs.size(); ++i)
+    terms.push_back(aig.addOr(aig.addAnd(inputs[i], inputs[i+1]), aig.addIte(inputs[i], inputs[i+2], ~inputs[i+1])));
+  AigLit root = aig.addAnd(terms);
+
+  CnfEncoder tseitin(aig, false, false), pg(aig, true, false), pgMux(aig, true, true);
+  tseitin.assertLit(root);
+  pg.assertLit(root);
+  pgMux.assertLit(root);
+  CHECK(pg.cnf().numClauses() < tseitin.cnf().numClauses());
+  CHECK(pgMux.cnf().numClauses() < pg.cnf().numClauses());
+
+  // asserting the complement later adds the missing direction only
+  unsigned before = pg.cnf().numClauses();
+  int d = pg.defineLit(root);
+  CHECK(d != 0 && pg.cnf().numClauses() > before);
+}
+
+void testAddCnf() {
+  Cnf cnf;
+  int a = cnf.newVar(), b = cnf.newVar(), c = cnf.newVar();
+  cnf.addClause(a, b);
+  cnf.addClause(-a, c);
+  cnf.addClause(-b, -c);
+  cnf.addClause(-c);
+
+  SWORD::sword solver;
+  std::vector<SWORD::Signal*> vars = addCnf(solver, cnf);
+  CHECK(solver.solve());
+  CHECK(solver.getVariableAssignment(vars[b])[0] == SWORD::SWORD_TRUE);
+  CHECK(solver.getVariableAssignment(vars[c])[0] == SWORD::SWORD_FALSE);
+
+  solver.addAssertion(vars[a]);
+  CHECK(!solver.solve());
+}
+
+} /* namespace */
+
+int main() {
+  std::srand(1);
+  testAigSimplification();
+  testRewriteRules();
+  testEquisatisfiable();
+  testPolarityIsSmaller();
+  testAddCnf();
+  return 0;
+}
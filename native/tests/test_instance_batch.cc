@@ -0,0 +1,119 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "InstanceBatch.h"
+#include "Check.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace rsynth;
+
+namespace {
+
+bool split(const std::string& text, std::vector<std::string>& benchmarks, std::string& error) {
+  std::istringstream in(text);
+  BenchmarkStream stream(in);
+  for (std::string benchmark; stream.next(benchmark); )
+    benchmarks.push_back(benchmark);
+  error = stream.error();
+  return error.empty();
+}
+
+bool startsWith(const std::string& s, const char* prefix) {
+  return s.compare(0, std::string(prefix).size(), prefix) == 0;
+}
+
+void testSplit() {
+  std::vector<std::string> benchmarks;
+  std::string error;
+  CHECK(split("; two benchmarks ( with a stray paren\n"
+              "(benchmark a :source { a ) in \\} braces } :formula true)\n"
+              "\n(benchmark b :notes \"(\" :formula false) ; trailing\n",
+              benchmarks, error));
+  CHECK(benchmarks.size() == 2);
+  CHECK(startsWith(benchmarks[0], "(benchmark a") && benchmarks[0][benchmarks[0].size() - 1] == ')');
+  CHECK(benchmarks[1] == "(benchmark b :notes \"(\" :formula false)");
+
+  const char* bad[] = {
+    "(benchmark a :formula true) x",
+    "(benchmark a :formula true))",
+    "(benchmark a :formula true)\n(benchmark b",
+  };
+  for (unsigned i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i) {
+    benchmarks.clear();
+    CHECK(!split(bad[i], benchmarks, error));
+    CHECK(startsWith(error, "line "));
+  }
+  CHECK(error.compare(0, 7, "line 2:") == 0);
+}
+
+void testSolve() {
+  const char* texts[] = {
+    "(benchmark s :status sat :extrafuns ((x BitVec[8])) :formula (= (bvmul x bv3[8]) bv21[8]))",
+    "(benchmark u :extrafuns ((x BitVec[4])) :formula (and (bvult x bv3[4]) (bvugt x bv2[4])))",
+    "(benchmark e :formula (= y bv0[4]))",
+    // the reader passes hex digits on, libsword throws on the Z
+    "(benchmark t :extrafuns ((x BitVec[8])) :formula (= x bvhexZZ))",
+  };
+  std::vector<Instance> instances;
+  for (unsigned i = 0; i < sizeof(texts) / sizeof(texts[0]); ++i) {
+    Instance instance;
+    instance.name = std::to_string(i);
+    instance.text = texts[i];
+    instances.push_back(instance);
+  }
+  Instance missing;
+  missing.name = missing.path = "/nonexistent.cnf";
+  instances.push_back(missing);
+
+  std::vector<size_t> order;
+  std::vector<std::string> results;
+  solveInstances(instances, 3, [&](size_t i, const Instance& instance, const std::string& result) {
+    CHECK(instance.name == instances[i].name);
+    order.push_back(i);
+    results.push_back(result);
+  });
+  CHECK(order.size() == instances.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    CHECK(order[i] == i);
+  CHECK(startsWith(results[0], "sat "));
+  CHECK(results[0].find(" load=") != std::string::npos && results[0].find(" solve=") != std::string::npos);
+  CHECK(results[0].find(" cpu=") != std::string::npos && results[0].find(" status=sat") != std::string::npos);
+  CHECK(startsWith(results[1], "unsat "));
+  CHECK(startsWith(results[2], "error ") && results[2].find("undeclared symbol y") != std::string::npos);
+  CHECK(startsWith(results[3], "error ") && results[3].find("exception") != std::string::npos);
+  CHECK(startsWith(results[4], "error ") && results[4].find("DIMACS") != std::string::npos);
+}
+
+void testStream() {
+  // benchmarks ahead of a broken tail are solved and reported in order
+  std::istringstream in(
+    "(benchmark a :extrafuns ((x BitVec[4])) :formula (= x bv3[4]))\n"
+    "(benchmark b :formula false)\n"
+    "(benchmark c :formula true)\n"
+    "garbage\n");
+  BenchmarkStream stream(in);
+  size_t n = 0;
+  std::vector<std::string> names, results;
+  solveInstances([&](Instance& instance) {
+    if (!stream.next(instance.text)) return false;
+    instance.name = std::to_string(++n);
+    return true;
+  }, 2, [&](size_t i, const Instance& instance, const std::string& result) {
+    CHECK(i == names.size() && instance.text.empty());
+    names.push_back(instance.name);
+    results.push_back(result);
+  });
+  CHECK(names.size() == 3 && names[0] == "1" && names[2] == "3");
+  CHECK(startsWith(results[0], "sat ") && startsWith(results[1], "unsat ") && startsWith(results[2], "sat "));
+  CHECK(stream.error() == "line 4: text between benchmarks");
+}
+
+} /* namespace */
+
+int main() {
+  testSplit();
+  testSolve();
+  testStream();
+  return 0;
+}
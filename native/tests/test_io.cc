@@ -0,0 +1,115 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "Aig.h"
+#include "Aiger.h"
+#include "Cnf.h"
+#include "Dimacs.h"
+#include "Check.h"
+
+#include "libsword.h"
+
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+using namespace rsynth;
+
+namespace {
+
+std::vector<uint64_t> randomPatterns(unsigned n) {
+  std::vector<uint64_t> in(n);
+  for (unsigned i = 0; i < n; ++i)
+    in[i] = ((uint64_t)std::rand() << 40) ^ ((uint64_t)std::rand() << 20) ^ std::rand();
+  return in;
+}
+
+void testAigerRoundTrip() {
+  for (unsigned round = 0; round < 20; ++round) {
+    Aig aig;
+    std::vector<AigLit> pool;
+    for (unsigned i = 0; i < 5; ++i)
+      pool.push_back(aig.addInput(i % 2 ? "x[" + std::string(1, '0' + i) + "]" : ""));
+    for (unsigned i = 0; i < 30; ++i) {
+      AigLit a = pool[std::rand() % pool.size()] ^ (std::rand() & 1);
+      AigLit b = pool[std::rand() % pool.size()] ^ (std::rand() & 1);
+      pool.push_back(std::rand() % 2 ? aig.addAnd(a, b) : aig.addXor(a, b));
+    }
+    std::vector<AigLit> outputs(pool.end() - 3, pool.end());
+    outputs.push_back(aig_True);
+    std::vector<std::string> names(1, "miter");
+
+    std::stringstream file;
+    CHECK(writeAiger(file, aig, outputs, names));
+
+    Aig copy;
+    std::vector<AigLit> copyOutputs;
+    std::vector<std::string> copyNames;
+    CHECK(readAiger(file, copy, copyOutputs, &copyNames));
+    CHECK(copy.numInputs() == aig.numInputs());
+    CHECK(copy.numAnds() <= aig.numAnds() && copy.numXors() <= aig.numXors());
+    CHECK(copyNames.size() == 4 && copyNames[0] == "miter" && copyNames[1].empty());
+    for (unsigned i = 0; i < aig.numInputs(); ++i)
+      CHECK(copy.inputName(i) == aig.inputName(i));
+
+    std::vector<uint64_t> in = randomPatterns(aig.numInputs());
+    std::vector<uint64_t> a = aig.simulate(in), b = copy.simulate(in);
+    CHECK(copyOutputs.size() == outputs.size());
+    for (unsigned i = 0; i < outputs.size(); ++i)
+      CHECK(Aig::value(a, outputs[i]) == Aig::value(b, copyOutputs[i]));
+  }
+}
+
+void testAigerAscii() {
+  // o0 = x & ~y, o1 = ~o0
+  std::istringstream file("aag 3 2 0 2 1\n2\n4\n6\n7\n6 2 5\ni0 x\ni1 y\nc\ncomment\n");
+  Aig aig;
+  std::vector<AigLit> outputs;
+  CHECK(readAiger(file, aig, outputs));
+  CHECK(aig.numInputs() == 2 && aig.inputName(1) == "y");
+  AigLit x(aig.inputs()[0]), y(aig.inputs()[1]);
+  CHECK(outputs.size() == 2 && outputs[0] == aig.addAnd(x, ~y) && outputs[1] == ~outputs[0]);
+
+  std::istringstream latch("aag 1 0 1 0 0\n2 3\n");
+  CHECK(!readAiger(latch, aig, outputs));
+  std::istringstream order("aag 3 2 0 1 1\n2\n4\n6\n6 8 2\n");
+  CHECK(!readAiger(order, aig, outputs));
+}
+
+void testDimacs() {
+  Aig aig;
+  AigLit a = aig.addInput("a"), b = aig.addInput("b"), c = aig.addInput();
+  CnfEncoder enc(aig);
+  enc.assertLit(aig.addXor(aig.addOr(a, ~b), c));
+  enc.assertLit(aig.addAnd(~a, b));
+  std::vector<std::string> names = enc.symbols();
+  CHECK(names[enc.inputVar(0)] == "a" && names[enc.inputVar(2)] == "i2");
+
+  std::stringstream file;
+  CHECK(writeDimacs(file, enc.cnf(), names));
+  Cnf cnf;
+  std::vector<std::string> copyNames;
+  CHECK(readDimacs(file, cnf, &copyNames));
+  CHECK(cnf.numVars == enc.cnf().numVars);
+  CHECK(cnf.lits == enc.cnf().lits && cnf.starts == enc.cnf().starts);
+  CHECK(copyNames[enc.inputVar(1)] == "b");
+
+  SWORD::sword solver;
+  std::vector<SWORD::Signal*> vars = addCnf(solver, cnf, &copyNames);
+  CHECK(solver.solve());
+  // ~a & b makes the OR false, so c must be true
+  CHECK(solver.getVariableAssignment(vars[enc.inputVar(0)])[0] == SWORD::SWORD_FALSE);
+  CHECK(solver.getVariableAssignment(vars[enc.inputVar(2)])[0] == SWORD::SWORD_TRUE);
+
+  std::istringstream bad("p cnf 2 1\n1 3 0\n");
+  Cnf rejected;
+  CHECK(!readDimacs(bad, rejected));
+}
+
+} /* namespace */
+
+int main() {
+  std::srand(1);
+  testAigerRoundTrip();
+  testAigerAscii();
+  testDimacs();
+  return 0;
+}
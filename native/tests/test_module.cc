@@ -0,0 +1,142 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "Check.h"
+
+#include "libsword.h"
+#include "libmodule.h"
+#include "modules/CardinalityLessThan.h"
+#include "modules/PhaseHint.h"
+
+#include <vector>
+
+using namespace SWORD;
+
+namespace {
+
+unsigned long value(const sword& solver, PSignal s) {
+  std::vector<int> bits = solver.getVariableAssignment(s);
+  unsigned long x = 0;
+  for (unsigned i = 0; i < bits.size(); ++i)
+    if (bits[i] == SWORD_TRUE)
+      x |= 1ul << i;
+  return x;
+}
+
+unsigned ones(unsigned long x) {
+  unsigned n = 0;
+  for (; x; x &= x - 1) ++n;
+  return n;
+}
+
+/**
+ * y is a copy of x, propagated bit by bit through the range overloads
+ */
+class CopyBits : public SwordModule {
+  public:
+    CopyBits(sword* swd, PSignal x, PSignal y)
+      : SwordModule(swd), _x(signalToLiterals(x)), _y(signalToLiterals(y))
+    {
+      useVariables(_x);
+      useVariables(_y);
+    }
+
+    virtual Clause* propagate() {
+      for (unsigned i = 0; i < _x.size(); ++i) {
+        Lit x = getValue(_x[i]) == l_True ? _x[i] : ~_x[i];
+        Lit y = getValue(_y[i]) == l_True ? _y[i] : ~_y[i];
+        if (isFree(_x[i]) || isFree(_y[i])) {
+          if (!isFree(_x[i]))
+            inferLiteral(sign(x) ? ~_y[i] : _y[i], &x, &x + 1);
+          else if (!isFree(_y[i]))
+            inferLiteral(sign(y) ? ~_x[i] : _x[i], &y, &y + 1);
+        } else if (sign(x) != sign(y)) {
+          conflict_set_t& conflict = scratchBuffer();
+          conflict.clear();
+          conflict.push_back(x);
+          conflict.push_back(y);
+          return makeConflict(conflict.data(), conflict.data() + conflict.size());
+        }
+      }
+      return NULL;
+    }
+
+  private:
+    const std::vector<Lit> _x, _y;
+};
+
+void testCardinality() {
+  {
+    // card < 1 leaves no room for the one bit x >= 7 needs
+    sword solver;
+    PSignal x = solver.addVariable(4, "x");
+    solver.addAssertion(solver.addOperator(UGE, x, solver.addConstant(4, 7)));
+    solver.addAndAssertModule(new CardinalityLessThan(&solver, x, 1));
+    CHECK(!solver.solve());
+  }
+  {
+    sword solver;
+    PSignal x = solver.addVariable(8, "x");
+    solver.addAssertion(solver.addOperator(EQUAL, x, solver.addConstant(8, 0)), false);
+    solver.addAndAssertModule(new CardinalityLessThan(&solver, x, 2));
+    CHECK(solver.solve());
+    CHECK(ones(value(solver, x)) == 1);
+  }
+  {
+    // maxOnes 0 conflicts on the empty set of ones
+    sword solver;
+    PSignal x = solver.addVariable(3, "x");
+    solver.addAndAssertModule(new CardinalityLessThan(&solver, x, 0));
+    CHECK(!solver.solve());
+  }
+}
+
+void testRangeHelpers() {
+  {
+    sword solver;
+    PSignal x = solver.addVariable(8, "x"), y = solver.addVariable(8, "y");
+    solver.addAssertion(solver.addOperator(EQUAL, x, solver.addConstant(8, 0xa5)));
+    solver.addAndAssertModule(new CopyBits(&solver, x, y));
+    CHECK(solver.solve());
+    CHECK(value(solver, y) == 0xa5);
+  }
+  {
+    sword solver;
+    PSignal x = solver.addVariable(8, "x"), y = solver.addVariable(8, "y");
+    solver.addAssertion(solver.addOperator(EQUAL, x, y), false);
+    solver.addAndAssertModule(new CopyBits(&solver, x, y));
+    CHECK(!solver.solve());
+  }
+}
+
+void testPhaseHint() {
+  // SWORD_TRUE/SWORD_FALSE per bit, least significant first, -1 = don't care
+  const int pattern[] = { 1, 0, -1, 1, 1, -1, 0, 1 };
+  std::vector<int> phases(pattern, pattern + 8);
+  {
+    sword solver;
+    PSignal x = solver.addVariable(8, "x");
+    solver.addAndAssertModule(new PhaseHint(&solver, x, phases));
+    CHECK(solver.solve());
+    std::vector<int> bits = solver.getVariableAssignment(x);
+    CHECK(bits.size() == 8);
+    for (unsigned i = 0; i < bits.size(); ++i)
+      CHECK(phases[i] == SWORD_DONTCARE || bits[i] == phases[i]);
+  }
+  {
+    // a hint never overrides a constraint
+    sword solver;
+    PSignal x = solver.addVariable(8, "x");
+    solver.addAssertion(solver.addOperator(EQUAL, x, solver.addConstant(8, 0x46)));
+    solver.addAndAssertModule(new PhaseHint(&solver, x, phases));
+    CHECK(solver.solve());
+    CHECK(value(solver, x) == 0x46);
+  }
+}
+
+} /* namespace */
+
+int main() {
+  testCardinality();
+  testRangeHelpers();
+  testPhaseHint();
+  return 0;
+}
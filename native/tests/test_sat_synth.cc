@@ -0,0 +1,218 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "SatSynthesizer.h"
+#include "Check.h"
+#include "DistanceTable.h"
+
+#include "libsword.h"
+
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <vector>
+
+using namespace rsynth;
+
+namespace {
+
+/**
+ * optimal lengths of all width-3 permutations by breadth-first search
+ */
+std::map<std::vector<unsigned>, unsigned> distances(const std::vector<Gate>& gates) {
+  std::map<std::vector<unsigned>, unsigned> dist;
+  std::vector<std::vector<unsigned> > frontier(1, simulate(3, gates, std::vector<unsigned>()));
+  dist[frontier[0]] = 0;
+  for (unsigned d = 1; !frontier.empty(); ++d) {
+    std::vector<std::vector<unsigned> > next;
+    for (unsigned i = 0; i < frontier.size(); ++i)
+      for (unsigned g = 0; g < gates.size(); ++g) {
+        std::vector<unsigned> p(8);
+        for (unsigned row = 0; row < 8; ++row)
+          p[row] = apply(gates[g], frontier[i][row]);
+        if (dist.insert(std::make_pair(p, d)).second)
+          next.push_back(p);
+      }
+    frontier.swap(next);
+  }
+  return dist;
+}
+
+void testOptimal(bool lazy) {
+  SWORD::sword solver;
+  SatSynthesizer synth(solver, 3);
+  synth.setLazy(lazy);
+  std::map<std::vector<unsigned>, unsigned> dist = distances(synth.gates());
+  std::map<std::vector<unsigned>, unsigned>::const_iterator it = dist.begin();
+  for (unsigned n = 0; it != dist.end(); ++n, ++it) {
+    if (n % 1009 != 0 && it->second != 0) continue;
+    std::vector<unsigned> circuit;
+    CHECK(synth.synthesize(it->first, 10, circuit));
+    CHECK(circuit.size() == it->second);
+    CHECK(simulate(3, synth.gates(), circuit) == it->first);
+    CHECK(SatSynthesizer::lowerBound(3, it->first) <= it->second);
+  }
+  CHECK(synth.stats().calls > 0);
+  CHECK(lazy ? synth.stats().refinements > 0 : synth.stats().refinements == 0);
+}
+
+void testWidthFour() {
+  SWORD::sword solver;
+  SatSynthesizer synth(solver, 4);
+  for (unsigned round = 0; round < 5; ++round) {
+    std::vector<unsigned> random;
+    for (unsigned p = 0; p < 4; ++p)
+      random.push_back(std::rand() % synth.gates().size());
+    std::vector<unsigned> target = simulate(4, synth.gates(), random);
+    std::vector<unsigned> circuit;
+    CHECK(synth.synthesize(target, 4, circuit));
+    CHECK(circuit.size() <= 4 && simulate(4, synth.gates(), circuit) == target);
+
+    // one gate less than optimal is refuted, a fixed length may be longer
+    if (!circuit.empty())
+      CHECK(!synth.solve(target, circuit.size() - 1, circuit));
+  }
+}
+
+void testLazyWide() {
+  // width 8 with only a few of the 256 rows encoded
+  SWORD::sword solver;
+  SatSynthesizer synth(solver, 8);
+  synth.setLazy(true);
+  std::vector<unsigned> random;
+  for (unsigned p = 0; p < 4; ++p)
+    random.push_back(std::rand() % synth.gates().size());
+  std::vector<unsigned> target = simulate(8, synth.gates(), random);
+  std::vector<unsigned> circuit;
+  CHECK(synth.synthesize(target, 4, circuit));
+  CHECK(simulate(8, synth.gates(), circuit) == target);
+  CHECK(synth.stats().rows < 64);
+}
+
+void testSymmetryBreaking() {
+  SWORD::sword solver;
+  SatSynthesizer synth(solver, 3);
+  std::vector<unsigned> identity(8), circuit;
+  for (unsigned row = 0; row < 8; ++row)
+    identity[row] = row;
+  // a gate followed by itself is ordered away, not so without ordering
+  CHECK(!synth.solve(identity, 2, circuit));
+  synth.setSymmetryBreaking(false, false);
+  CHECK(synth.solve(identity, 2, circuit));
+  CHECK(circuit.size() == 2 && circuit[0] == circuit[1]);
+
+  // wire symmetries keep the optimal lengths, in particular of targets
+  // that are invariant under swapping wires
+  synth.setSymmetryBreaking(true, true);
+  std::map<std::vector<unsigned>, unsigned> dist = distances(synth.gates());
+  std::map<std::vector<unsigned>, unsigned>::const_iterator it = dist.begin();
+  unsigned symmetric = 0;
+  for (unsigned n = 0; it != dist.end(); ++n, ++it) {
+    std::vector<unsigned> swapped(8);
+    for (unsigned row = 0; row < 8; ++row) {
+      unsigned image = (row & 4) | ((row & 1) << 1) | ((row >> 1) & 1);
+      unsigned target = it->first[row];
+      swapped[image] = (target & 4) | ((target & 1) << 1) | ((target >> 1) & 1);
+    }
+    if (swapped != it->first || (n % 13 != 0 && it->second != 0)) continue;
+    ++symmetric;
+    CHECK(synth.synthesize(it->first, 10, circuit));
+    CHECK(circuit.size() == it->second);
+    CHECK(simulate(3, synth.gates(), circuit) == it->first);
+  }
+  CHECK(symmetric > 10);
+}
+
+void testDistanceTable() {
+  SWORD::sword solver;
+  SatSynthesizer synth(solver, 3);
+  std::map<std::vector<unsigned>, unsigned> dist = distances(synth.gates());
+  std::vector<std::pair<uint64_t, unsigned char> > entries;
+  std::map<std::vector<unsigned>, unsigned>::const_iterator it;
+  for (it = dist.begin(); it != dist.end(); ++it)
+    if (it->second <= 4)
+      entries.push_back(std::make_pair(DistanceTable::key(it->first), it->second));
+
+  // written and read back, a truncated file is rejected
+  std::stringstream file;
+  CHECK(writeDistances(file, DistanceTable(3, 4, entries)));
+  DistanceTable table, truncated;
+  CHECK(readDistances(file, table));
+  CHECK(table.width() == 3 && table.maxDepth() == 4 && table.size() == entries.size());
+  std::istringstream cut(file.str().substr(0, file.str().size() - 1));
+  CHECK(!readDistances(cut, truncated));
+  // a corrupt count is rejected before anything is allocated for it
+  const uint64_t counts[] = { 40321, uint64_t(1) << 39 };   // more than 8!, than the file holds
+  for (unsigned c = 0; c < 2; ++c) {
+    std::string header = file.str().substr(0, 16);
+    uint64_t count = counts[c];
+    for (unsigned i = 0; i < 8; ++i)
+      header += char(count >> 8 * i & 0xff);
+    std::istringstream corrupt(header + file.str().substr(24));
+    CHECK(!readDistances(corrupt, truncated));
+  }
+
+  // the table refutes short lengths, prefixes and suffixes the next ones;
+  // the optimal lengths stay those of the BFS
+  synth.setDistanceTable(&table);
+  unsigned n = 0;
+  for (it = dist.begin(); it != dist.end(); ++it, ++n) {
+    CHECK(table.lowerBound(it->first) == (it->second <= 4 ? it->second : 5));
+    if (n % 613 != 0) continue;
+    std::vector<unsigned> circuit;
+    CHECK(synth.synthesize(it->first, 10, circuit));
+    CHECK(circuit.size() == it->second);
+    CHECK(simulate(3, synth.gates(), circuit) == it->first);
+    if (it->second > 4) {
+      std::vector<unsigned> shorter;
+      CHECK(!synth.solve(it->first, it->second - 1, shorter));
+    }
+  }
+  CHECK(synth.stats().skipped > synth.stats().calls);
+}
+
+void testUnreachable(bool lazy) {
+  SWORD::sword solver;
+  SatSynthesizer synth(solver, 3);
+  synth.setLazy(lazy);
+  std::vector<unsigned> target(8), circuit;
+  for (unsigned row = 0; row < 8; ++row)
+    target[row] = row;
+  target[6] = 7;
+  target[7] = 6;
+  // a single transposition needs more than two gates
+  CHECK(!synth.synthesize(target, 2, circuit));
+  CHECK(circuit.empty());
+  CHECK(synth.stats().positions == 2);
+
+  // lazily, a candidate for some of the rows is refuted once more rows are
+  // added, and must not be handed back
+  SWORD::sword wideSolver;
+  SatSynthesizer wide(wideSolver, 4);
+  wide.setLazy(lazy);
+  unsigned refuted = 0;
+  for (unsigned n = 0; n < 10; ++n) {
+    std::vector<unsigned> gates;
+    for (unsigned p = 0; p < 8; ++p)
+      gates.push_back(std::rand() % wide.gates().size());
+    if (!wide.synthesize(simulate(4, wide.gates(), gates), 3, circuit)) {
+      CHECK(circuit.empty());
+      ++refuted;
+    }
+  }
+  CHECK(refuted > 0);
+  CHECK(!lazy || wide.stats().refinements > 0);
+}
+
+} /* namespace */
+
+int main() {
+  std::srand(1);
+  testOptimal(false);
+  testOptimal(true);
+  testWidthFour();
+  testLazyWide();
+  testSymmetryBreaking();
+  testDistanceTable();
+  testUnreachable(false);
+  testUnreachable(true);
+  return 0;
+}
@@ -0,0 +1,136 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "SmtReader.h"
+#include "Check.h"
+
+#include "libsword.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace rsynth;
+
+namespace {
+
+unsigned long value(const SWORD::sword& solver, SWORD::Signal* s) {
+  std::vector<int> bits = solver.getVariableAssignment(s);
+  unsigned long x = 0;
+  for (unsigned i = 0; i < bits.size(); ++i)
+    if (bits[i] == SWORD::SWORD_TRUE)
+      x |= 1ul << i;
+  return x;
+}
+
+bool parse(SWORD::sword& solver, SmtReader& reader, const std::string& text) {
+  return reader.parse(text.data(), text.data() + text.size());
+}
+
+void testModel() {
+  SWORD::sword solver;
+  SmtReader reader(solver);
+  CHECK(parse(solver, reader,
+    "; factor 143 with a known low nibble\n"
+    "(benchmark factor\n"
+    " :logic QF_BV :status sat\n"
+    " :source { generated, with an escaped \\} brace }\n"
+    " :extrafuns ((x BitVec[8]) (y BitVec[8]))\n"
+    " :extrapreds ((p))\n"
+    " :assumption (bvugt x bv1[8])\n"
+    " :formula (and (= (bvmul x y) bv143[8]) (bvugt y bv1[8])\n"
+    "   (let (?t (extract[3:0] x)) (= ?t bv11[4]))\n"
+    "   (flet ($f (bvult x y)) (iff p $f))\n"
+    "   (= (concat (extract[7:4] y) bvbin0000) (bvand y bvhexF0)))\n"
+    ")\n"));
+  CHECK(reader.status() == "sat" && reader.numAssertions() == 2);
+  CHECK(solver.solve());
+  unsigned long x = value(solver, reader.variable("x")), y = value(solver, reader.variable("y"));
+  CHECK((x * y) % 256 == 143 && (x & 15) == 11 && x > 1 && y > 1);
+  CHECK(value(solver, reader.variable("p")) == (x < y ? 1ul : 0ul));
+}
+
+void testOperators() {
+  SWORD::sword solver;
+  SmtReader reader(solver);
+  CHECK(parse(solver, reader,
+    "(benchmark ops :extrafuns ((a BitVec[4]) (b BitVec[8]))\n"
+    " :formula (and (= a bv9[4])\n"
+    "   (= b (concat (rotate_left[1] a) (zero_extend[2] (extract[2:1] a))))\n"
+    "   (= (sign_extend[4] a) bv249[8]) (= (repeat[2] a) bv153[8])\n"
+    "   (distinct a bv0[4] bv1[4]) (= (ite (bvslt a bv0[4]) bv1[1] bv0[1]) bit1)))\n"));
+  CHECK(solver.solve());
+  // rotate_left[1] 1001 = 0011, extract[2:1] 1001 = 00
+  CHECK(value(solver, reader.variable("b")) == 0x30);
+}
+
+void testWideConstants() {
+  SWORD::sword solver;
+  SmtReader reader(solver);
+  // 2^70 + 5 in 80 bits and a 19-digit value that still fits in 64
+  CHECK(parse(solver, reader,
+    "(benchmark w :extrafuns ((a BitVec[64]) (b BitVec[80]) (c BitVec[64]))\n"
+    " :formula (and (= a bv1234567890123456789[64])\n"
+    "   (= b bv1180591620717411303429[80])\n"
+    "   (= c bv18446744073709551615[64])))\n"));
+  CHECK(solver.solve());
+  CHECK(value(solver, reader.variable("a")) == 1234567890123456789ul);
+  CHECK(value(solver, reader.variable("c")) == 18446744073709551615ul);
+  std::vector<int> b = solver.getVariableAssignment(reader.variable("b"));
+  CHECK(b.size() == 80);
+  for (unsigned i = 0; i < b.size(); ++i)
+    CHECK((b[i] == SWORD::SWORD_TRUE) == (i == 0 || i == 2 || i == 70));
+}
+
+void testUnsat() {
+  SWORD::sword solver;
+  SmtReader reader(solver);
+  CHECK(parse(solver, reader,
+    "(benchmark u :status unsat :extrafuns ((x BitVec[4]))\n"
+    " :formula (and (bvult x bv3[4]) (bvugt x bv2[4])))"));
+  CHECK(!solver.solve());
+}
+
+void testErrors() {
+  const char* bad[] = {
+    "(benchmark e :formula (= x bv0[4]))",
+    "(benchmark e :extrafuns ((x BitVec[4])) :formula (= x bv0[8]))",
+    "(benchmark e :extrafuns ((f BitVec[4] BitVec[4])))",
+    "(benchmark e :extrafuns ((x BitVec[4])) :formula (= (extract[4:0] x) bv0[5]))",
+    "(benchmark e :extrafuns ((x BitVec[4])) :formula (frobnicate x))",
+    "(benchmark e :extrafuns ((x BitVec[4])) :formula (= x bv0[4])",
+  };
+  for (unsigned i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i) {
+    SWORD::sword solver;
+    SmtReader reader(solver);
+    CHECK(!parse(solver, reader, bad[i]));
+    CHECK(reader.error().compare(0, 5, "line ") == 0);
+  }
+}
+
+void testFile() {
+  char path[] = "/tmp/test_smtXXXXXX";
+  int fd = mkstemp(path);
+  CHECK(fd >= 0);
+  FILE* f = fdopen(fd, "w");
+  std::fprintf(f, "(benchmark f :extrafuns ((x BitVec[16]))\n :formula (= (bvadd x bv1[16]) bv0[16]))\n");
+  std::fclose(f);
+
+  SWORD::sword solver;
+  SmtReader reader(solver);
+  bool ok = reader.parseFile(path);
+  std::remove(path);
+  CHECK(ok && solver.solve());
+  CHECK(value(solver, reader.variable("x")) == 0xffff);
+  CHECK(!reader.parseFile("/nonexistent.smt") && !reader.error().empty());
+}
+
+} /* namespace */
+
+int main() {
+  testModel();
+  testOperators();
+  testWideConstants();
+  testUnsat();
+  testErrors();
+  testFile();
+  return 0;
+}
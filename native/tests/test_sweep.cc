@@ -0,0 +1,135 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "Aig.h"
+#include "Sweep.h"
+#include "Check.h"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace rsynth;
+
+namespace {
+
+struct Gate { unsigned t, c1, c2; };
+
+Gate randomGate(unsigned width) {
+  Gate g;
+  g.t = std::rand() % width;
+  do g.c1 = std::rand() % width; while (g.c1 == g.t);
+  do g.c2 = std::rand() % width; while (g.c2 == g.t || g.c2 == g.c1);
+  return g;
+}
+
+/**
+ * applies a cascade of t ^= (c1 | ~c2) gates to the lines
+ */
+std::vector<AigLit> cascade(Aig& aig, std::vector<AigLit> lines, const std::vector<Gate>& gates) {
+  for (unsigned i = 0; i < gates.size(); ++i) {
+    const Gate& g = gates[i];
+    lines[g.t] = aig.addXor(lines[g.t], aig.addOr(lines[g.c1], ~lines[g.c2]));
+  }
+  return lines;
+}
+
+AigLit miter(Aig& aig, const std::vector<AigLit>& a, const std::vector<AigLit>& b) {
+  std::vector<AigLit> diff;
+  for (unsigned i = 0; i < a.size(); ++i)
+    diff.push_back(aig.addXor(a[i], b[i]));
+  return aig.addOr(diff);
+}
+
+/**
+ * every node of the original has the same function as its image
+ */
+void checkMap(const Aig& aig, const Aig& swept, const std::vector<AigLit>& map) {
+  CHECK(swept.numInputs() == aig.numInputs());
+  for (unsigned round = 0; round < 8; ++round) {
+    std::vector<uint64_t> in(aig.numInputs());
+    for (unsigned i = 0; i < in.size(); ++i)
+      in[i] = ((uint64_t)std::rand() << 40) ^ ((uint64_t)std::rand() << 20) ^ std::rand();
+    std::vector<uint64_t> before = aig.simulate(in), after = swept.simulate(in);
+    for (uint32_t n = 0; n < aig.numNodes(); ++n)
+      CHECK(before[n] == Aig::value(after, map[n]));
+  }
+}
+
+void testIdentityPairs() {
+  const unsigned width = 5;
+  for (unsigned round = 0; round < 10; ++round) {
+    std::vector<Gate> gates, padded;
+    for (unsigned i = 0; i < 8; ++i) {
+      gates.push_back(randomGate(width));
+      padded.push_back(gates.back());
+      if (std::rand() % 2) {
+        // a gate is its own inverse
+        Gate g = randomGate(width);
+        padded.push_back(g);
+        padded.push_back(g);
+      }
+    }
+
+    Aig aig;
+    std::vector<AigLit> lines;
+    for (unsigned i = 0; i < width; ++i)
+      lines.push_back(aig.addInput());
+    AigLit root = miter(aig, cascade(aig, lines, gates), cascade(aig, lines, padded));
+
+    std::vector<AigLit> map;
+    SweepStats stats;
+    Aig swept = sweep(aig, map, &stats);
+    CHECK((map[node(root)] ^ sign(root)) == aig_False);
+    CHECK(swept.numAnds() + swept.numXors() <= aig.numAnds() + aig.numXors());
+    checkMap(aig, swept, map);
+  }
+}
+
+void testDifferentCircuits() {
+  const unsigned width = 5;
+  std::vector<Gate> gates;
+  for (unsigned i = 0; i < 8; ++i)
+    gates.push_back(randomGate(width));
+  std::vector<Gate> extended(gates);
+  extended.push_back(randomGate(width));
+
+  Aig aig;
+  std::vector<AigLit> lines;
+  for (unsigned i = 0; i < width; ++i)
+    lines.push_back(aig.addInput());
+  AigLit root = miter(aig, cascade(aig, lines, gates), cascade(aig, lines, extended));
+
+  std::vector<AigLit> map;
+  Aig swept = sweep(aig, map);
+  CHECK(map[node(root)] != aig_False && map[node(root)] != aig_True);
+  checkMap(aig, swept, map);
+}
+
+void testRandomGraphs() {
+  for (unsigned round = 0; round < 20; ++round) {
+    Aig aig;
+    std::vector<AigLit> pool;
+    for (unsigned i = 0; i < 6; ++i)
+      pool.push_back(aig.addInput());
+    for (unsigned i = 0; i < 60; ++i) {
+      AigLit a = pool[std::rand() % pool.size()] ^ (std::rand() & 1);
+      AigLit b = pool[std::rand() % pool.size()] ^ (std::rand() & 1);
+      pool.push_back(std::rand() % 3 ? aig.addAnd(a, b) : aig.addXor(a, b));
+    }
+
+    // few patterns leave many candidates for the solver to refute
+    std::vector<AigLit> map;
+    SweepStats stats;
+    Aig swept = sweep(aig, map, &stats, 1, 2);
+    CHECK(stats.proved + stats.disproved == stats.checks);
+    checkMap(aig, swept, map);
+  }
+}
+
+} /* namespace */
+
+int main() {
+  std::srand(1);
+  testIdentityPairs();
+  testDifferentCircuits();
+  testRandomGraphs();
+  return 0;
+}
@@ -0,0 +1,179 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+#include "Aig.h"
+#include "AigToSword.h"
+#include "Word.h"
+#include "Check.h"
+
+#include "libsword.h"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace rsynth;
+
+namespace {
+
+/**
+ * input patterns where pattern j assigns j to the inputs (up to 6 inputs)
+ */
+std::vector<uint64_t> exhaustive(const Aig& aig) {
+  CHECK(aig.numInputs() <= 6);
+  std::vector<uint64_t> in(aig.numInputs(), 0);
+  for (unsigned i = 0; i < in.size(); ++i)
+    for (unsigned j = 0; j < 64; ++j)
+      if ((j >> i) & 1)
+        in[i] |= 1ull << j;
+  return in;
+}
+
+uint64_t wordValue(const std::vector<uint64_t>& values, const Word& w, unsigned pattern) {
+  uint64_t x = 0;
+  for (unsigned i = 0; i < w.size(); ++i)
+    x |= ((Aig::value(values, w[i]) >> pattern) & 1) << i;
+  return x;
+}
+
+void testSelect() {
+  for (unsigned round = 0; round < 10; ++round) {
+    Aig aig;
+    Word index = addWord(aig, 5, "idx");
+    std::vector<uint64_t> table;
+    for (unsigned j = 0; j < 27; ++j)
+      table.push_back(std::rand() % 8);
+    Word w = addSelect(aig, index, table, 3);
+
+    std::vector<uint64_t> values = aig.simulate(exhaustive(aig));
+    for (unsigned j = 0; j < 32; ++j)
+      CHECK(wordValue(values, w, j) == (j < table.size() ? table[j] : 0));
+  }
+}
+
+void testSelectSharing() {
+  Aig aig;
+  Word index = addWord(aig, 4, "idx");
+  std::vector<uint64_t> identity, swapped;
+  for (unsigned j = 0; j < 16; ++j) {
+    identity.push_back(j);
+    swapped.push_back(j ^ 1);
+  }
+  // a table that passes the index through needs no nodes
+  CHECK(addSelect(aig, index, identity, 4) == index);
+  CHECK(addSelect(aig, index, swapped, 4)[0] == ~index[0]);
+  CHECK(aig.numAnds() == 0 && aig.numXors() == 0);
+
+  std::vector<uint64_t> constant(16, 5);
+  CHECK(addSelect(aig, index, constant, 3) == constWord(5, 3));
+}
+
+void testSelectInSword() {
+  Aig aig;
+  Word index = addWord(aig, 3, "idx");
+  std::vector<uint64_t> table;
+  for (unsigned j = 0; j < 8; ++j)
+    table.push_back((j * 5 + 3) % 8);
+  Word w = addSelect(aig, index, table, 3);
+
+  SWORD::sword solver;
+  AigToSword lower(aig, solver);
+  solver.addAssertion(solver.addOperator(SWORD::EQUAL, lower.word(w), solver.addConstant(3, 6ul)));
+  CHECK(solver.solve());
+  unsigned j = 0;
+  for (unsigned i = 0; i < index.size(); ++i)
+    j |= (unsigned)lower.inputValue(i) << i;
+  CHECK(table[j] == 6);
+}
+
+void testBitOperations() {
+  // 3 state bits, a 2-bit index that can be out of range, one value bit
+  Aig aig;
+  Word s = addWord(aig, 3, "s"), idx = addWord(aig, 2, "idx");
+  AigLit v = aig.addInput("v");
+  AigLit sel = addBitSelect(aig, s, idx);
+  Word upd = addBitUpdate(aig, s, idx, v);
+  Word flip = addBitFlip(aig, s, idx, v);
+
+  std::vector<uint64_t> values = aig.simulate(exhaustive(aig));
+  for (unsigned j = 0; j < 64; ++j) {
+    unsigned state = j & 7, i = (j >> 3) & 3, bit = j >> 5;
+    bool inRange = i < 3;
+    CHECK(((Aig::value(values, sel) >> j) & 1) == (inRange ? (state >> i) & 1 : 0));
+    unsigned updated = inRange ? (state & ~(1u << i)) | (bit << i) : state;
+    CHECK(wordValue(values, upd, j) == updated);
+    CHECK(wordValue(values, flip, j) == (inRange ? state ^ (bit << i) : state));
+  }
+}
+
+void testDecoderSharing() {
+  Aig aig;
+  Word s = addWord(aig, 12, "s"), idx = addWord(aig, 4, "idx");
+  AigLit f = aig.addInput("f");
+  std::vector<AigLit> lines = addDecoder(aig, idx, 12);
+  unsigned decoder = aig.numAnds();
+  CHECK(decoder <= 12 + 8);
+  CHECK(lines.size() == 12 && addDecoder(aig, idx, 12) == lines);
+  CHECK(aig.numAnds() == decoder);
+
+  // the second flip on the same index reuses decoder and guards
+  addBitFlip(aig, s, idx, f);
+  unsigned nodes = aig.numAnds() + aig.numXors();
+  Word again = addBitFlip(aig, s, idx, f);
+  CHECK(aig.numAnds() + aig.numXors() == nodes);
+  addBitSelect(aig, again, idx);
+  CHECK(aig.numAnds() <= nodes + 2 * 12);
+}
+
+unsigned popCount(unsigned x) {
+  unsigned n = 0;
+  for (; x; x &= x - 1) ++n;
+  return n;
+}
+
+void testCounting() {
+  Aig aig;
+  Word bits = addWord(aig, 6, "b");
+  Word count = addPopCount(aig, bits);
+  CHECK(count.size() == 3);
+  Word a(bits.begin(), bits.begin() + 3), b(bits.begin() + 3, bits.end());
+  Word dist = addHamming(aig, a, b);
+  std::vector<AigLit> unary = addUnaryCount(aig, bits, 4);
+  std::vector<AigLit> atMost;
+  for (unsigned k = 0; k <= 6; ++k)
+    atMost.push_back(addAtMost(aig, bits, k));
+
+  std::vector<uint64_t> values = aig.simulate(exhaustive(aig));
+  for (unsigned j = 0; j < 64; ++j) {
+    unsigned n = popCount(j);
+    CHECK(wordValue(values, count, j) == n);
+    CHECK(wordValue(values, dist, j) == popCount((j & 7) ^ (j >> 3)));
+    for (unsigned k = 0; k < unary.size(); ++k)
+      CHECK(((Aig::value(values, unary[k]) >> j) & 1) == (n > k));
+    for (unsigned k = 0; k < atMost.size(); ++k)
+      CHECK(((Aig::value(values, atMost[k]) >> j) & 1) == (n <= k));
+  }
+}
+
+void testHammingInSword() {
+  Aig aig;
+  Word a = addWord(aig, 4, "a"), b = addWord(aig, 4, "b");
+  Word dist = addHamming(aig, a, b);
+  SWORD::sword solver;
+  AigToSword lower(aig, solver);
+  solver.addAssertion(solver.addOperator(SWORD::EQUAL, lower.word(dist), solver.addConstant(3, 4ul)));
+  CHECK(solver.solve());
+  for (unsigned i = 0; i < 4; ++i)
+    CHECK(lower.inputValue(i) != lower.inputValue(4 + i));
+}
+
+} /* namespace */
+
+int main() {
+  std::srand(1);
+  testSelect();
+  testSelectSharing();
+  testSelectInSword();
+  testBitOperations();
+  testDecoderSharing();
+  testCounting();
+  testHammingInSword();
+  return 0;
+}
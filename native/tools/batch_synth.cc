@@ -0,0 +1,142 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+//
+// Synthesises many targets of one width with one encoding per thread
+// (Batch.h).
+//
+//   batch_synth [-w width] [-k length] [-j threads] [--shortest] [--lazy]
+//               [--fresh] [--random count:gates] [--seed n] [file]
+//
+// Targets are read one per line as the images of rows 0 .. 2^width-1
+// (Permutation mapping order) from file or stdin, or are the permutations
+// of <count> random circuits of <gates> gates. Without --shortest each
+// target is checked for a cascade of exactly <length> gates, with it the
+// shortest cascade of at most <length> gates is searched (--lazy as in
+// sat_synth). --fresh builds a new instance for every target instead, for
+// comparison. One line per target is written to stdout, in input order:
+//
+//   <sat|unsat> G(t, c1, c2)...
+//
+// and the throughput to stderr.
+
+#include "Batch.h"
+#include "Cascade.h"
+#include "Random.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/time.h>
+#include <thread>
+#include <vector>
+
+using namespace rsynth;
+
+namespace {
+
+double now() {
+  timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+void usage() {
+  std::fprintf(stderr, "usage: batch_synth [-w width] [-k length] [-j threads] [--shortest] [--lazy]\n"
+                       "                   [--fresh] [--random count:gates] [--seed n] [file]\n");
+  std::exit(1);
+}
+
+bool isPermutation(const std::vector<unsigned>& target, unsigned width) {
+  if (target.size() != (1u << width)) return false;
+  std::vector<bool> seen(target.size(), false);
+  for (unsigned row = 0; row < target.size(); ++row) {
+    if (target[row] >= target.size() || seen[target[row]]) return false;
+    seen[target[row]] = true;
+  }
+  return true;
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+  unsigned width = 4, length = 5, threads = std::thread::hardware_concurrency();
+  unsigned count = 0, gatesPerTarget = 0, seed = 1;
+  bool shortest = false, lazy = false, fresh = false;
+  const char* input = "-";
+  for (int i = 1; i < argc; ++i) {
+    if      (!std::strcmp(argv[i], "-w") && i + 1 < argc) width = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "-k") && i + 1 < argc) length = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "-j") && i + 1 < argc) threads = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--shortest")) shortest = true;
+    else if (!std::strcmp(argv[i], "--lazy")) lazy = true;
+    else if (!std::strcmp(argv[i], "--fresh")) fresh = true;
+    else if (!std::strcmp(argv[i], "--random") && i + 1 < argc) {
+      if (std::sscanf(argv[++i], "%u:%u", &count, &gatesPerTarget) != 2) usage();
+    }
+    else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) seed = std::atoi(argv[++i]);
+    else if (argv[i][0] != '-' || !std::strcmp(argv[i], "-")) input = argv[i];
+    else usage();
+  }
+  if (width < 3 || width > 10) usage();
+
+  std::vector<Gate> gates = allGates(width);
+  std::vector<std::vector<unsigned> > targets;
+  if (count) {
+    uint64_t state = xorshiftState(seed);
+    for (unsigned n = 0; n < count; ++n)
+      targets.push_back(simulate(width, gates, randomCircuit(gates.size(), gatesPerTarget, state)));
+  } else {
+    std::ifstream file;
+    if (std::strcmp(input, "-")) {
+      file.open(input);
+      if (!file) {
+        std::fprintf(stderr, "cannot open %s\n", input);
+        return 1;
+      }
+    }
+    std::istream& in = std::strcmp(input, "-") ? file : std::cin;
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.empty() || line[0] == '#') continue;
+      std::istringstream images(line);
+      std::vector<unsigned> target;
+      for (unsigned image; images >> image; )
+        target.push_back(image);
+      if (!isPermutation(target, width)) {
+        std::fprintf(stderr, "not a permutation of %u rows: %s\n", 1u << width, line.c_str());
+        return 1;
+      }
+      targets.push_back(target);
+    }
+  }
+
+  double start = now();
+  std::vector<BatchResult> results;
+  if (!fresh) {
+    results = shortest ? synthesizeBatch(width, length, targets, threads, lazy)
+                       : solveBatch(width, length, targets, threads);
+  } else {
+    // one batch per target: every target gets its own instance
+    for (unsigned n = 0; n < targets.size(); ++n) {
+      std::vector<std::vector<unsigned> > one(1, targets[n]);
+      results.push_back((shortest ? synthesizeBatch(width, length, one, 1, lazy)
+                                  : solveBatch(width, length, one, 1))[0]);
+    }
+  }
+  double seconds = now() - start;
+
+  for (unsigned n = 0; n < results.size(); ++n) {
+    std::printf("%s", results[n].found ? "sat" : "unsat");
+    for (unsigned p = 0; results[n].found && p < results[n].circuit.size(); ++p) {
+      const Gate& g = gates[results[n].circuit[p]];
+      std::printf(" G(%u, %u, %u)", g.t, g.c1, g.c2);
+    }
+    std::printf("\n");
+  }
+  std::fprintf(stderr, "%u targets in %.3fs, %.1f per second\n", (unsigned)targets.size(),
+               seconds, seconds > 0 ? targets.size() / seconds : 0.0);
+  return 0;
+}
@@ -0,0 +1,166 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+//
+// Compares Tseitin and polarity-aware CNF generation on gate-cascade
+// instances: "k gates G(t, c1, c2) implement the permutation P", with
+// t' = t XOR (c1 OR NOT c2).
+//
+//   cnf_bench [-w width] [-k length] [--identity] [--seed n] [--solve]
+//             [--aiger file] [--dimacs file]
+//
+// --identity asks for a k-gate identity without adjacent identical gates
+// (template search), otherwise P is the permutation of a random k-gate
+// circuit. --solve loads each CNF into sword and reports the solve time.
+// --aiger writes the AIG with the asserted roots as outputs, --dimacs the
+// polarity+mux CNF with the selector names as symbols.
+
+#include "Aig.h"
+#include "Cascade.h"
+#include "Cnf.h"
+#include "Aiger.h"
+#include "Dimacs.h"
+
+#include "libsword.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <vector>
+
+using namespace rsynth;
+
+namespace {
+
+double now() {
+  timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+double peakMegabytes() {
+  rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  return ru.ru_maxrss / 1024.0;
+}
+
+/**
+ * builds the cascade constraints, returns the asserted roots
+ */
+std::vector<AigLit> buildCascade(Aig& aig, unsigned width, unsigned length,
+    const std::vector<Gate>& gates, const std::vector<unsigned>& target, bool identity) {
+  std::vector<AigLit> roots;
+  std::vector<std::vector<AigLit> > sel(length);
+  for (unsigned p = 0; p < length; ++p) {
+    for (unsigned g = 0; g < gates.size(); ++g) {
+      char name[64];
+      std::snprintf(name, sizeof(name), "sel_%u_%u", p, g);
+      sel[p].push_back(aig.addInput(name));
+    }
+    // exactly one gate per position
+    roots.push_back(aig.addOr(sel[p]));
+    for (unsigned g = 0; g < gates.size(); ++g)
+      for (unsigned h = g + 1; h < gates.size(); ++h)
+        roots.push_back(~aig.addAnd(sel[p][g], sel[p][h]));
+  }
+  if (identity) {
+    // forbid trivially cancelling neighbours
+    for (unsigned p = 0; p + 1 < length; ++p)
+      for (unsigned g = 0; g < gates.size(); ++g)
+        roots.push_back(~aig.addAnd(sel[p][g], sel[p+1][g]));
+  }
+
+  for (unsigned row = 0; row < target.size(); ++row) {
+    std::vector<AigLit> state = addCascade(aig, width, gates, sel, row);
+    for (unsigned w = 0; w < width; ++w)
+      roots.push_back((target[row] >> w) & 1 ? state[w] : ~state[w]);
+  }
+  return roots;
+}
+
+void usage() {
+  std::fprintf(stderr, "usage: cnf_bench [-w width] [-k length] [--identity] [--seed n] [--solve]\n"
+                       "                 [--aiger file] [--dimacs file]\n");
+  std::exit(1);
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+  unsigned width = 3, length = 4, seed = 1;
+  bool identity = false, solve = false;
+  const char* aigerPath = 0;
+  const char* dimacsPath = 0;
+  for (int i = 1; i < argc; ++i) {
+    if      (!std::strcmp(argv[i], "-w") && i + 1 < argc) width  = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "-k") && i + 1 < argc) length = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) seed = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--identity")) identity = true;
+    else if (!std::strcmp(argv[i], "--solve")) solve = true;
+    else if (!std::strcmp(argv[i], "--aiger") && i + 1 < argc) aigerPath = argv[++i];
+    else if (!std::strcmp(argv[i], "--dimacs") && i + 1 < argc) dimacsPath = argv[++i];
+    else usage();
+  }
+  if (width < 3) usage();
+
+  std::srand(seed);
+  std::vector<Gate> gates = allGates(width);
+  std::vector<unsigned> target(1u << width);
+  for (unsigned row = 0; row < target.size(); ++row)
+    target[row] = row;
+  if (!identity) {
+    unsigned last = gates.size();
+    for (unsigned p = 0; p < length; ++p) {
+      unsigned g;
+      do { g = std::rand() % gates.size(); } while (g == last);
+      last = g;
+      for (unsigned row = 0; row < target.size(); ++row)
+        target[row] = apply(gates[g], target[row]);
+    }
+  }
+
+  double start = now();
+  Aig aig;
+  std::vector<AigLit> roots = buildCascade(aig, width, length, gates, target, identity);
+  std::printf("width %u, length %u, %s target: %u inputs, %u ANDs, %u XORs (%.2fs, %.0f MB peak)\n",
+      width, length, identity ? "identity" : "random", aig.numInputs(),
+      aig.numAnds(), aig.numXors(), now() - start, peakMegabytes());
+
+  if (aigerPath) {
+    std::ofstream out(aigerPath, std::ios::binary);
+    if (!writeAiger(out, aig, roots)) {
+      std::fprintf(stderr, "cannot write %s\n", aigerPath);
+      return 1;
+    }
+  }
+
+  const char* names[] = { "tseitin", "polarity", "polarity+mux" };
+  std::printf("%-14s %10s %10s %10s %10s\n", "encoding", "vars", "clauses", "encode[s]", solve ? "solve[s]" : "");
+  for (unsigned mode = 0; mode < 3; ++mode) {
+    start = now();
+    CnfEncoder enc(aig, mode > 0, mode > 1);
+    for (unsigned i = 0; i < roots.size(); ++i)
+      enc.assertLit(roots[i]);
+    double encodeTime = now() - start;
+    std::printf("%-14s %10d %10u %10.3f", names[mode], enc.cnf().numVars, enc.cnf().numClauses(), encodeTime);
+
+    if (dimacsPath && mode == 2) {
+      std::ofstream out(dimacsPath);
+      if (!writeDimacs(out, enc.cnf(), enc.symbols())) {
+        std::fprintf(stderr, "cannot write %s\n", dimacsPath);
+        return 1;
+      }
+    }
+
+    if (solve) {
+      start = now();
+      SWORD::sword solver;
+      addCnf(solver, enc.cnf());
+      bool sat = solver.solve();
+      std::printf(" %10.3f %s", now() - start, sat ? "sat" : "unsat");
+    }
+    std::printf("\n");
+  }
+  return 0;
+}
@@ -0,0 +1,111 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+//
+// Checks two gate cascades for equivalence with EquivalenceChecker.
+//
+//   equiv_check -w width [--words n] a b
+//
+// Each file lists gates G(t, c1, c2), one per line, first gate first. The
+// three numbers of a line are taken in order, so "3 0 1", "G(3, 0, 1)"
+// (sat_synth output) and "G(t=3, c1=0, c2=1)" (CustomGate repr) all work;
+// digits directly after a letter (the 1 of c1) are not numbers. Lines
+// without numbers and text after '#' are skipped. Prints "equivalent", or
+// "different" and an input on which the outputs differ (wire 0 first), and
+// the statistics; exits with 0, 1, or 2 on an error.
+
+#include "EquivalenceChecker.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <sys/time.h>
+#include <vector>
+
+using namespace rsynth;
+
+namespace {
+
+double now() {
+  timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+void usage() {
+  std::fprintf(stderr, "usage: equiv_check -w width [--words n] a b\n");
+  std::exit(2);
+}
+
+/**
+ * @return false (with a message) if the file cannot be read or a line is
+ *   not a gate on width wires
+ */
+bool readCascade(const char* path, unsigned width, std::vector<Gate>& gates) {
+  std::ifstream in(path);
+  if (!in) {
+    std::fprintf(stderr, "cannot open %s\n", path);
+    return false;
+  }
+  std::string line;
+  for (unsigned lineNo = 1; std::getline(in, line); ++lineNo) {
+    std::vector<unsigned> numbers;
+    for (size_t i = 0; i < line.size() && line[i] != '#'; ) {
+      if (std::isalpha((unsigned char)line[i])) {
+        while (i < line.size() && std::isalnum((unsigned char)line[i])) ++i;
+      } else if (std::isdigit((unsigned char)line[i])) {
+        numbers.push_back(std::strtoul(line.c_str() + i, 0, 10));
+        while (i < line.size() && std::isdigit((unsigned char)line[i])) ++i;
+      } else {
+        ++i;
+      }
+    }
+    if (numbers.empty())
+      continue;
+    Gate g = { numbers[0], numbers.size() > 1 ? numbers[1] : 0, numbers.size() > 2 ? numbers[2] : 0 };
+    if (numbers.size() != 3 || g.t >= width || g.c1 >= width || g.c2 >= width) {
+      std::fprintf(stderr, "%s:%u: not a gate on %u wires\n", path, lineNo, width);
+      return false;
+    }
+    gates.push_back(g);
+  }
+  return true;
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+  unsigned width = 0, words = 16;
+  std::vector<const char*> paths;
+  for (int i = 1; i < argc; ++i) {
+    if      (!std::strcmp(argv[i], "-w") && i + 1 < argc) width = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--words") && i + 1 < argc) words = std::atoi(argv[++i]);
+    else if (argv[i][0] != '-') paths.push_back(argv[i]);
+    else usage();
+  }
+  if (width < 1 || width > 64 || paths.size() != 2) usage();
+
+  std::vector<Gate> a, b;
+  if (!readCascade(paths[0], width, a) || !readCascade(paths[1], width, b))
+    return 2;
+
+  EquivalenceChecker checker(width, words);
+  uint64_t cex = 0;
+  double start = now();
+  bool same = checker.equivalent(a, b, cex);
+  const EquivalenceStats& stats = checker.stats();
+  if (same) {
+    std::printf("equivalent\n");
+  } else {
+    std::printf("different ");
+    for (unsigned i = 0; i < width; ++i)
+      std::printf("%u", (unsigned)((cex >> i) & 1));
+    std::printf("\n");
+  }
+  std::printf("%.3fs: %u + %u gates, %s, %u nodes, %u merged\n", now() - start,
+      (unsigned)a.size(), (unsigned)b.size(),
+      stats.simulated ? "simulation" : stats.structural ? "structural" : stats.swept ? "sweeping" : "sword",
+      stats.nodes, stats.merged);
+  return same ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+//
+// Exact synthesis with SatSynthesizer.
+//
+//   sat_synth [-w width] [-k max-length] [--lazy] [--no-order] [--wires]
+//             [--table file] [--random length] [--seed n] [image...]
+//
+// The target is given as the images of rows 0 .. 2^width-1 (Permutation
+// mapping order), or as the permutation of a random circuit of the given
+// length. --lazy encodes truth-table rows on demand, --no-order drops the
+// ordering of commuting gates and --wires breaks wire relabelling
+// symmetries of the target and --table reads a distance table of the same
+// width (precompute_bfs.py --distances, see SatSynthesizer.h) to refute
+// short lengths without solving. Prints the statistics
+// and the gates of the shortest cascade as G(t, c1, c2), first gate first.
+
+#include "DistanceTable.h"
+#include "Random.h"
+#include "SatSynthesizer.h"
+
+#include "libsword.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sys/time.h>
+#include <vector>
+
+using namespace rsynth;
+
+namespace {
+
+double now() {
+  timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+void usage() {
+  std::fprintf(stderr, "usage: sat_synth [-w width] [-k max-length] [--lazy] [--no-order] [--wires]\n"
+                       "                 [--table file] [--random length] [--seed n] [image...]\n");
+  std::exit(1);
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+  unsigned width = 3, maxLength = 12, random = 0, seed = 1;
+  bool lazy = false, ordering = true, wires = false;
+  const char* tablePath = 0;
+  std::vector<unsigned> target;
+  for (int i = 1; i < argc; ++i) {
+    if      (!std::strcmp(argv[i], "-w") && i + 1 < argc) width = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "-k") && i + 1 < argc) maxLength = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--lazy")) lazy = true;
+    else if (!std::strcmp(argv[i], "--no-order")) ordering = false;
+    else if (!std::strcmp(argv[i], "--wires")) wires = true;
+    else if (!std::strcmp(argv[i], "--table") && i + 1 < argc) tablePath = argv[++i];
+    else if (!std::strcmp(argv[i], "--random") && i + 1 < argc) random = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) seed = std::atoi(argv[++i]);
+    else if (argv[i][0] >= '0' && argv[i][0] <= '9') target.push_back(std::atoi(argv[i]));
+    else usage();
+  }
+  if (width < 3 || width > 10) usage();
+
+  std::vector<Gate> gates = allGates(width);
+  if (target.empty()) {
+    uint64_t state = xorshiftState(seed);
+    target = simulate(width, gates, randomCircuit(gates.size(), random, state));
+  }
+  std::vector<bool> seen(1u << width, false);
+  if (target.size() != (1u << width)) usage();
+  for (unsigned row = 0; row < target.size(); ++row) {
+    if (target[row] >= target.size() || seen[target[row]]) {
+      std::fprintf(stderr, "not a permutation of %u rows\n", (unsigned)target.size());
+      return 1;
+    }
+    seen[target[row]] = true;
+  }
+
+  DistanceTable table;
+  if (tablePath) {
+    std::ifstream in(tablePath, std::ios::binary);
+    if (!in || !readDistances(in, table)) {
+      std::fprintf(stderr, "cannot read distance table %s\n", tablePath);
+      return 1;
+    }
+    if (table.width() != width)
+      std::fprintf(stderr, "distance table is for width %u, not used\n", table.width());
+  }
+
+  SWORD::sword solver;
+  SatSynthesizer synth(solver, width);
+  synth.setDistanceTable(&table);
+  synth.setLazy(lazy);
+  synth.setSymmetryBreaking(ordering, wires);
+  std::vector<unsigned> circuit;
+  double start = now();
+  bool found = synth.synthesize(target, maxLength, circuit);
+  const SynthesisStats& stats = synth.stats();
+  std::printf("%.3fs: %u calls, %u positions, %u of %u rows, %u refinements, %u skipped\n",
+      now() - start, stats.calls, stats.positions, stats.rows, (unsigned)target.size(),
+      stats.refinements, stats.skipped);
+  if (!found) {
+    std::printf("no cascade of at most %u gates\n", maxLength);
+    return 1;
+  }
+  std::printf("%u gates:", (unsigned)circuit.size());
+  for (unsigned p = 0; p < circuit.size(); ++p) {
+    const Gate& g = gates[circuit[p]];
+    std::printf(" G(%u, %u, %u)", g.t, g.c1, g.c2);
+  }
+  std::printf("\n");
+  return 0;
+}
@@ -0,0 +1,94 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+//
+// Solves many instances in one process instead of one bin/sword call each.
+//
+//   sword_batch [-j threads] [manifest]
+//   sword_batch [-j threads] -s [stream]
+//
+// The manifest (stdin if omitted or "-") lists one instance file per line:
+// SMT-LIB 1.2 (.smt), DIMACS (.cnf) or AIGER (.aig, .aag; all outputs are
+// asserted). Blank lines and lines starting with '#' are skipped. With -s
+// the input is instead a stream of concatenated SMT-LIB benchmarks, named
+// <stream>:<n> in the results, and solved while the stream is still being
+// read. Every instance gets its own sword object; the threads take
+// instances in turn. One line per instance is written to stdout, in input
+// order (see solveInstance):
+//
+//   <name> <sat|unsat> <seconds> load=<s> solve=<s> cpu=<s> <sizes>
+//   <name> error <seconds> <message>
+
+#include "InstanceBatch.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace rsynth;
+
+namespace {
+
+void usage() {
+  std::fprintf(stderr, "usage: sword_batch [-j threads] [-s] [manifest|stream]\n");
+  std::exit(1);
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+  unsigned threads = std::thread::hardware_concurrency();
+  const char* input = "-";
+  bool stream = false;
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "-j") && i + 1 < argc) threads = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "-s")) stream = true;
+    else if (argv[i][0] != '-' || !std::strcmp(argv[i], "-")) input = argv[i];
+    else usage();
+  }
+
+  std::ifstream file;
+  if (std::strcmp(input, "-")) {
+    file.open(input, std::ios::binary);
+    if (!file) {
+      std::fprintf(stderr, "cannot open %s\n", input);
+      return 1;
+    }
+  }
+  std::istream& in = std::strcmp(input, "-") ? file : std::cin;
+
+  auto print = [](size_t, const Instance& instance, const std::string& result) {
+    std::printf("%s %s\n", instance.name.c_str(), result.c_str());
+    std::fflush(stdout);
+  };
+
+  if (stream) {
+    // benchmarks are cut off the stream as the workers ask for them
+    BenchmarkStream benchmarks(in);
+    std::string source = std::strcmp(input, "-") ? input : "stdin";
+    size_t n = 0;
+    solveInstances([&](Instance& instance) {
+      if (!benchmarks.next(instance.text)) return false;
+      instance.name = source + ":" + std::to_string(++n);
+      return true;
+    }, threads, print);
+    if (!benchmarks.error().empty()) {
+      std::fprintf(stderr, "%s: %s\n", source.c_str(), benchmarks.error().c_str());
+      return 1;
+    }
+  } else {
+    std::vector<Instance> instances;
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.empty() || line[0] == '#') continue;
+      Instance instance;
+      instance.name = instance.path = line;
+      instances.push_back(instance);
+    }
+    solveInstances(instances, threads, print);
+  }
+  return 0;
+}
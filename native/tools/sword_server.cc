@@ -0,0 +1,275 @@
+//  vim: ft=cpp:ts=2:sw=2:expandtab
+//
+// Answers synthesis queries "does a cascade of k gates implement P" over a
+// Unix domain socket, so that Python callers can issue many small queries
+// without building an encoding (or starting a process) for each one.
+//
+//   sword_server [-j idle] [-m cells] [--warm width:length[:count]]... socket
+//
+// Instances are kept per (width, length): the cascade with P left open is
+// encoded once (CascadeEncoding) and every query only adds P as
+// assumptions. A query takes an idle instance or builds a new one, and
+// returns it afterwards; at most <idle> instances per key are kept
+// (default: number of cores), and an instance is rebuilt after
+// RECYCLE_LIMIT queries so that learnt clauses do not pile up. --warm
+// builds instances before the socket is opened.
+//
+// An encoding has one node per gate, row and position, about 0.8 kB each.
+// A (width, length) of more than MAX_CELLS such cells (e.g. width 8 beyond
+// 3 gates, width 10 at all) is answered with an error, and instances in
+// use and idle together hold at most <cells> of them (default
+// 4 * MAX_CELLS, about 1 GB): idle instances of other keys are dropped to
+// make room, and a query that still does not fit gets an error.
+//
+// Each connection is served by its own thread and may send any number of
+// requests; all integers are little-endian:
+//
+//   request: u8 width, u8 length, u16 reserved (0), u16 target[2^width]
+//   reply:   u8 status (0 unsat, 1 sat, 2 error), u8 n, u16 gate[n]
+//
+// target[row] is the image of row, as Permutation.mapping. A sat reply
+// carries the gates as indices into CustomGate.distinct_gates(width), first
+// gate first. After an error the server closes the connection if the
+// request header was malformed, otherwise it reads the next request.
+
+#include "Cascade.h"
+
+#include "libsword.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+using namespace rsynth;
+
+namespace {
+
+const unsigned MAX_WIDTH     = 10;
+const unsigned MAX_LENGTH    = 64;
+const unsigned RECYCLE_LIMIT = 10000;
+const size_t   MAX_CELLS     = size_t(1) << 18;
+
+/**
+ * gate x row x position cells of the encoding of (width, length)
+ */
+size_t cells(unsigned width, unsigned length) {
+  return (allGates(width).size() << width) * length;
+}
+
+enum { UNSAT = 0, SAT = 1, ERROR = 2 };
+
+struct Instance {
+  Instance(unsigned width, unsigned length)
+    : encoding(solver, width, length)
+    , queries(0)
+  { }
+
+  SWORD::sword    solver;
+  CascadeEncoding encoding;
+  unsigned        queries;
+};
+
+/**
+ * idle instances per (width, length)
+ */
+class Pool {
+public:
+  Pool(unsigned maxIdle, size_t maxCells) : _maxIdle(maxIdle), _maxCells(maxCells), _cells(0) { }
+
+  /**
+   * an idle or new instance, NULL if it does not fit into the cell budget
+   */
+  Instance* take(unsigned width, unsigned length) {
+    size_t size = cells(width, length);
+    {
+      std::lock_guard<std::mutex> guard(_lock);
+      std::vector<Instance*>& idle = _idle[std::make_pair(width, length)];
+      if (!idle.empty()) {
+        Instance* instance = idle.back();
+        idle.pop_back();
+        return instance;
+      }
+      // drop idle instances of other keys until the new one fits
+      std::map<std::pair<unsigned, unsigned>, std::vector<Instance*> >::iterator it = _idle.begin();
+      for (; _cells + size > _maxCells && it != _idle.end(); ++it) {
+        for (; _cells + size > _maxCells && !it->second.empty(); it->second.pop_back()) {
+          _cells -= cells(it->first.first, it->first.second);
+          delete it->second.back();
+        }
+      }
+      if (_cells + size > _maxCells)
+        return 0;
+      _cells += size;
+    }
+    // built outside the lock, other keys stay available meanwhile
+    return new Instance(width, length);
+  }
+
+  void give(Instance* instance) {
+    unsigned width = instance->encoding.width(), length = instance->encoding.length();
+    std::lock_guard<std::mutex> guard(_lock);
+    if (instance->queries < RECYCLE_LIMIT) {
+      std::vector<Instance*>& idle = _idle[std::make_pair(width, length)];
+      if (idle.size() < _maxIdle) {
+        idle.push_back(instance);
+        return;
+      }
+    }
+    _cells -= cells(width, length);
+    delete instance;
+  }
+
+private:
+  unsigned   _maxIdle;
+  size_t     _maxCells;
+  size_t     _cells;      // of all instances, in use or idle
+  std::mutex _lock;
+  std::map<std::pair<unsigned, unsigned>, std::vector<Instance*> > _idle;
+};
+
+bool readAll(int fd, unsigned char* buf, size_t n) {
+  while (n > 0) {
+    ssize_t r = read(fd, buf, n);
+    if (r <= 0) return false;
+    buf += r;
+    n -= r;
+  }
+  return true;
+}
+
+bool writeAll(int fd, const unsigned char* buf, size_t n) {
+  while (n > 0) {
+    ssize_t r = write(fd, buf, n);
+    if (r <= 0) return false;
+    buf += r;
+    n -= r;
+  }
+  return true;
+}
+
+bool reply(int fd, unsigned status, const std::vector<unsigned>& gates) {
+  std::vector<unsigned char> buf(2 + 2 * gates.size());
+  buf[0] = status;
+  buf[1] = gates.size();
+  for (unsigned i = 0; i < gates.size(); ++i) {
+    buf[2 + 2 * i] = gates[i] & 0xff;
+    buf[3 + 2 * i] = gates[i] >> 8;
+  }
+  return writeAll(fd, &buf[0], buf.size());
+}
+
+void serve(Pool* pool, int fd) {
+  unsigned char header[4];
+  while (readAll(fd, header, sizeof(header))) {
+    unsigned width = header[0], length = header[1];
+    if (width < 3 || width > MAX_WIDTH || length > MAX_LENGTH || header[2] || header[3]) {
+      reply(fd, ERROR, std::vector<unsigned>());
+      break;
+    }
+
+    std::vector<unsigned char> buf(2u << width);
+    if (!readAll(fd, &buf[0], buf.size()))
+      break;
+    std::vector<unsigned> target(1u << width);
+    std::vector<bool> seen(target.size(), false);
+    bool valid = true;
+    for (unsigned row = 0; row < target.size(); ++row) {
+      target[row] = buf[2 * row] | (buf[2 * row + 1] << 8);
+      valid = valid && target[row] < target.size() && !seen[target[row]];
+      if (valid) seen[target[row]] = true;
+    }
+    if (!valid) {
+      if (!reply(fd, ERROR, std::vector<unsigned>())) break;
+      continue;
+    }
+
+    Instance* instance = cells(width, length) <= MAX_CELLS ? pool->take(width, length) : 0;
+    if (!instance) {
+      if (!reply(fd, ERROR, std::vector<unsigned>())) break;
+      continue;
+    }
+    bool sat = instance->encoding.solve(target);
+    ++instance->queries;
+    std::vector<unsigned> gates;
+    if (sat) gates = instance->encoding.circuit();
+    pool->give(instance);
+    if (!reply(fd, sat ? SAT : UNSAT, gates))
+      break;
+  }
+  close(fd);
+}
+
+void usage() {
+  std::fprintf(stderr, "usage: sword_server [-j idle] [-m cells] [--warm width:length[:count]]... socket\n");
+  std::exit(1);
+}
+
+} /* namespace */
+
+int main(int argc, char** argv) {
+  unsigned maxIdle = std::thread::hardware_concurrency();
+  size_t maxCells = 4 * MAX_CELLS;
+  const char* path = 0;
+  std::vector<unsigned> warm;   // width, length, count triples
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "-j") && i + 1 < argc) maxIdle = std::atoi(argv[++i]);
+    else if (!std::strcmp(argv[i], "-m") && i + 1 < argc) maxCells = std::strtoul(argv[++i], 0, 10);
+    else if (!std::strcmp(argv[i], "--warm") && i + 1 < argc) {
+      unsigned width, length, count = 1;
+      if (std::sscanf(argv[++i], "%u:%u:%u", &width, &length, &count) < 2 ||
+          width < 3 || width > MAX_WIDTH || length > MAX_LENGTH || cells(width, length) > MAX_CELLS)
+        usage();
+      warm.push_back(width);
+      warm.push_back(length);
+      warm.push_back(count);
+    }
+    else if (argv[i][0] != '-' && !path) path = argv[i];
+    else usage();
+  }
+  if (!path || std::strlen(path) >= sizeof(((sockaddr_un*)0)->sun_path)) usage();
+  if (maxIdle == 0) maxIdle = 1;
+
+  Pool pool(maxIdle, maxCells);
+  for (unsigned i = 0; i < warm.size(); i += 3) {
+    std::vector<Instance*> built;
+    for (unsigned n = 0; n < warm[i + 2]; ++n) {
+      Instance* instance = pool.take(warm[i], warm[i + 1]);
+      if (!instance) {
+        std::fprintf(stderr, "--warm %u:%u:%u exceeds -m\n", warm[i], warm[i + 1], warm[i + 2]);
+        return 1;
+      }
+      built.push_back(instance);
+    }
+    for (unsigned n = 0; n < built.size(); ++n)
+      pool.give(built[n]);
+  }
+
+  // a client that hangs up early must not kill the server
+  std::signal(SIGPIPE, SIG_IGN);
+
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  std::strcpy(addr.sun_path, path);
+  unlink(path);
+  if (listener < 0 || bind(listener, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(listener, 64) < 0) {
+    std::perror(path);
+    return 1;
+  }
+
+  for (;;) {
+    int fd = accept(listener, 0, 0);
+    if (fd < 0) continue;
+    std::thread(serve, &pool, fd).detach();
+  }
+}
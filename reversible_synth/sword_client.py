@@ -0,0 +1,80 @@
+"""
+Client for native/tools/sword_server: SAT queries over a Unix domain socket.
+"""
+
+import socket
+import struct
+from typing import List, Optional
+
+from .permutation import Permutation
+from .gates import CustomGate, Circuit
+
+
+class SwordServerError(RuntimeError):
+    """The server rejected a request."""
+
+
+class SwordClient:
+    """
+    One connection to a running sword_server.
+
+    The server keeps a warm encoding per (width, length), so a query costs
+    one solver call on an already built instance.
+    """
+
+    UNSAT, SAT, ERROR = 0, 1, 2
+
+    def __init__(self, path: str):
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sock.connect(path)
+        self._gates = {}
+
+    def close(self):
+        self.sock.close()
+
+    def __enter__(self) -> 'SwordClient':
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+    def _recv(self, n: int) -> bytes:
+        data = b''
+        while len(data) < n:
+            chunk = self.sock.recv(n - len(data))
+            if not chunk:
+                raise ConnectionError("sword_server closed the connection")
+            data += chunk
+        return data
+
+    def _distinct_gates(self, n_bits: int) -> List[CustomGate]:
+        if n_bits not in self._gates:
+            self._gates[n_bits] = CustomGate.distinct_gates(n_bits)
+        return self._gates[n_bits]
+
+    def synthesize(self, target: Permutation, length: int) -> Optional[Circuit]:
+        """
+        Find a circuit of exactly `length` gates implementing target.
+
+        Returns None if there is none.
+        """
+        mapping = [target(i) for i in range(target.size)]
+        request = struct.pack('<BBH%dH' % target.size, target.n_bits, length, 0, *mapping)
+        self.sock.sendall(request)
+
+        status, n = struct.unpack('<BB', self._recv(2))
+        if status == self.ERROR:
+            raise SwordServerError(f"invalid request: width {target.n_bits}, length {length}")
+        indices = struct.unpack('<%dH' % n, self._recv(2 * n))
+        if status == self.UNSAT:
+            return None
+        gates = self._distinct_gates(target.n_bits)
+        return Circuit(target.n_bits, [gates[i] for i in indices])
+
+    def synthesize_optimal(self, target: Permutation, max_depth: int = 10) -> Optional[Circuit]:
+        """Shortest circuit up to max_depth gates, by trying each length in turn."""
+        for length in range(max_depth + 1):
+            circuit = self.synthesize(target, length)
+            if circuit is not None:
+                return circuit
+        return None
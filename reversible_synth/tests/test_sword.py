@@ -0,0 +1,119 @@
+"""
+Tests for the libsword binding (needs `make -C native python`).
+"""
+
+import sys
+import threading
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+import pytest
+
+S = pytest.importorskip("reversible_synth._sword")
+
+
+def factor(n: int, width: int):
+    """Solver for a * b == n with 1 < a <= b, widths doubled to avoid overflow."""
+    s = S.Sword()
+    a, b = s.variable(width, "a"), s.variable(width, "b")
+    product = s.operator(S.MUL, s.zero_extend(a, width), s.zero_extend(b, width))
+    s.assertion(s.operator(S.EQUAL, product, s.constant(2 * width, n)))
+    s.assertion(s.operator(S.UGT, a, s.constant(width, 1)))
+    s.assertion(s.operator(S.ULE, a, b))
+    return s, a, b
+
+
+class TestSword:
+    """Building, solving and reading models."""
+
+    def test_model(self):
+        s, a, b = factor(143, 8)
+        assert s.solve()
+        assert (s.value(a), s.value(b)) == (11, 13)
+        bits = memoryview(s.model(a))
+        assert bits.format == 'i' and bits.readonly
+        assert bits.tolist() == [1, 1, 0, 1, 0, 0, 0, 0]
+        assert list(s.model(a)) == bits.tolist()
+
+    def test_assumptions_last_one_solve(self):
+        s, a, b = factor(143, 8)
+        s.assumption(s.operator(S.EQUAL, a, s.constant(8, 13)))
+        assert not s.solve()
+        assert s.solve()
+        s.assumption(s.extract(a, 1, 1), False)
+        assert not s.solve()
+
+    def test_wide_constants_and_vector_operators(self):
+        s = S.Sword()
+        x = s.variable(100, "x")
+        s.assertion(s.operator(S.EQUAL, x, s.constant(100, -3)))
+        low = [s.extract(x, i, i) for i in range(4)]
+        s.assertion(s.operator(S.AND, low[2:]))
+        assert s.solve()
+        assert s.value(x) == (1 << 100) - 3
+
+    def test_errors(self):
+        s, a, b = factor(15, 4)
+        other = S.Sword()
+        with pytest.raises(ValueError):
+            other.assertion(a)
+        with pytest.raises(TypeError):
+            s.operator(S.NOT, 1)
+        assert s.solve()
+        with pytest.raises(ValueError):
+            s.value(s.operator(S.NOT, a))
+
+    def test_unexported_opcodes_rejected(self):
+        s, a, b = factor(15, 4)
+        exported = {v for k, v in vars(S).items()
+                    if k.isupper() and k not in ("TRUE", "FALSE", "DONTCARE")}
+        # EXTRACT, REPEAT, SELECT, DISTINCT, ... take parameters or arrays
+        for op in set(range(-1, 64)) - exported:
+            with pytest.raises(ValueError):
+                s.operator(op, a, b)
+            with pytest.raises(ValueError):
+                s.operator(op, [a, b])
+        assert s.solve()
+
+
+class TestThreads:
+    """solve() releases the GIL."""
+
+    def test_other_threads_run_during_solve(self):
+        s, a, b = factor(4093 * 4091, 24)
+        ticks, solving, done = [0], threading.Event(), threading.Event()
+
+        def spin():
+            # counts only inside the solve() window; sleep(0) hands the GIL back
+            while not done.is_set():
+                solving.wait(0.01)
+                while solving.is_set():
+                    ticks[0] += 1
+                    time.sleep(0)
+
+        spinner = threading.Thread(target=spin)
+        spinner.start()
+        # without a release in solve() this thread would keep the GIL from
+        # set() to clear(), so the spinner could not count
+        interval = sys.getswitchinterval()
+        sys.setswitchinterval(60)
+        try:
+            solving.set()
+            assert s.solve()
+            solving.clear()
+        finally:
+            sys.setswitchinterval(interval)
+            solving.clear()
+            done.set()
+            spinner.join()
+        assert ticks[0] > 0
+        assert s.value(a) == 4091
+
+    def test_pool(self):
+        def job(n):
+            s, a, b = factor(n, 12)
+            return s.value(a) * s.value(b) if s.solve() else None
+
+        targets = [143, 221, 323, 437, 899, 97]
+        with ThreadPoolExecutor(4) as pool:
+            assert list(pool.map(job, targets)) == [143, 221, 323, 437, 899, None]
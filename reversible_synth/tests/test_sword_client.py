@@ -0,0 +1,70 @@
+"""
+Tests for the sword_server client (needs `make -C native`).
+"""
+
+import os
+import subprocess
+import time
+
+import pytest
+from reversible_synth.permutation import Permutation
+from reversible_synth.gates import CustomGate, Circuit
+from reversible_synth.synthesis_exact import ExactSynthesizer
+from reversible_synth.sword_client import SwordClient, SwordServerError
+
+SERVER = os.path.join(os.path.dirname(__file__), '..', '..', 'native', 'tools', 'sword_server')
+
+
+@pytest.fixture(scope='module')
+def server(tmp_path_factory):
+    if not os.path.exists(SERVER):
+        pytest.skip("native/tools/sword_server is not built")
+    path = str(tmp_path_factory.mktemp('sword') / 'socket')
+    proc = subprocess.Popen([SERVER, path])
+    for _ in range(100):
+        if os.path.exists(path):
+            break
+        time.sleep(0.05)
+    yield path
+    proc.kill()
+    proc.wait()
+
+
+class TestSwordClient:
+    """Queries against a running server."""
+
+    def test_optimal_matches_bfs(self, server):
+        """Shortest circuits agree in length with BFS."""
+        bfs = ExactSynthesizer(3)
+        circuit = Circuit(3, [CustomGate(0, 1, 2, 3), CustomGate(1, 2, 0, 3), CustomGate(2, 0, 1, 3)])
+        target = circuit.to_permutation()
+
+        with SwordClient(server) as client:
+            found = client.synthesize_optimal(target, max_depth=4)
+
+        assert found is not None
+        assert found.to_permutation() == target
+        assert len(found) == len(bfs.synthesize_bfs(target, max_depth=4))
+
+    def test_many_queries_one_connection(self, server):
+        """Unsat and sat answers alternate on one connection."""
+        identity = Permutation.identity(3)
+        with SwordClient(server) as client:
+            for gate in CustomGate.distinct_gates(3):
+                target = gate.to_permutation()
+                assert client.synthesize(identity, 1) is None
+                found = client.synthesize(target, 1)
+                assert found is not None and found.gates == [gate]
+
+    def test_invalid_request(self, server):
+        """Out-of-range widths are rejected."""
+        with SwordClient(server) as client:
+            with pytest.raises(SwordServerError):
+                client.synthesize(Permutation.identity(2), 1)
+
+    def test_oversized_encoding(self, server):
+        """Encodings beyond the server's size cap are refused, the connection stays usable."""
+        with SwordClient(server) as client:
+            with pytest.raises(SwordServerError):
+                client.synthesize(Permutation.identity(10), 1)
+            assert client.synthesize(Permutation.identity(3), 1) is None
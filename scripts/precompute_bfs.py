@@ -5,9 +5,13 @@ Pre-compute and cache BFS tables for fast identity generation.
 Usage:
     python precompute_bfs.py --width 3 --max-depth 6
     python precompute_bfs.py --width 4 --max-depth 8
+    python precompute_bfs.py --width 4 --max-depth 8 --distances
     
 The BFS table maps each reachable permutation to its shortest circuit.
 This is cached to disk so multiple generation jobs can share it.
+--distances also writes the optimal lengths alone in the binary format
+read by native/include/DistanceTable.h (widths up to 4), from the cached
+table if there is one.
 """
 
 import argparse
@@ -15,6 +19,7 @@ import os
 import sys
 import time
 import pickle
+import struct
 from pathlib import Path
 
 # Add parent directory to path
@@ -30,6 +35,11 @@ def get_cache_path(width: int, max_depth: int, cache_dir: str = "cache") -> Path
     return Path(cache_dir) / f"bfs_width{width}_depth{max_depth}.pkl"
 
 
+def get_distance_path(width: int, max_depth: int, cache_dir: str = "cache") -> Path:
+    """Get the path for the distance table of a BFS table."""
+    return Path(cache_dir) / f"bfs_width{width}_depth{max_depth}.dist"
+
+
 def precompute_bfs_table(width: int, max_depth: int, verbose: bool = True) -> dict:
     """
     Pre-compute BFS table mapping permutations to shortest circuits.
@@ -87,6 +97,37 @@ def save_bfs_table(table: dict, cache_path: Path, verbose: bool = True):
         print(f"  Saved to {cache_path} ({size_mb:.2f} MB)")
 
 
+def save_distance_table(table: dict, width: int, max_depth: int, path: Path,
+                        verbose: bool = True):
+    """
+    Save the optimal length of every permutation in a BFS table for the
+    native SatSynthesizer (see native/include/DistanceTable.h).
+
+    Little-endian: b"RSBFSD1\\n", u32 width, u32 max depth, u64 count,
+    u64 key[count] ascending, u8 distance[count]. A key holds the image
+    of row r in bits 4r .. 4r+3.
+    """
+    if width > 4:
+        raise ValueError("distance tables hold at most 4 bits per row")
+    entries = []
+    for perm, circuit in table.items():
+        key = 0
+        for row, image in enumerate(perm._map):
+            key |= image << (4 * row)
+        entries.append((key, len(circuit.gates)))
+    entries.sort()
+
+    path.parent.mkdir(parents=True, exist_ok=True)
+    with open(path, 'wb') as f:
+        f.write(b"RSBFSD1\n")
+        f.write(struct.pack("<IIQ", width, max_depth, len(entries)))
+        f.write(struct.pack(f"<{len(entries)}Q", *(key for key, _ in entries)))
+        f.write(bytes(d for _, d in entries))
+
+    if verbose:
+        print(f"  Saved distances to {path}")
+
+
 def load_bfs_table(cache_path: Path, verbose: bool = True) -> dict:
     """Load BFS table from disk."""
     from reversible_synth.gates import CustomGate, Circuit
@@ -122,21 +163,35 @@ def main():
                         help="Recompute even if cache exists")
     parser.add_argument("--quiet", "-q", action="store_true",
                         help="Suppress output")
+    parser.add_argument("--distances", action="store_true",
+                        help="Also write the optimal lengths for native/ (width <= 4)")
     
     args = parser.parse_args()
     verbose = not args.quiet
     
     cache_path = get_cache_path(args.width, args.max_depth, args.cache_dir)
     
+    if args.distances and args.width > 4:
+        print("--distances needs width <= 4", file=sys.stderr)
+        return 1
+    
     if cache_path.exists() and not args.force:
         if verbose:
             print(f"Cache already exists: {cache_path}")
-            print("Use --force to recompute")
-        return 0
-    
-    # Compute and save
-    table = precompute_bfs_table(args.width, args.max_depth, verbose)
-    save_bfs_table(table, cache_path, verbose)
+        if not args.distances:
+            if verbose:
+                print("Use --force to recompute")
+            return 0
+        table = load_bfs_table(cache_path, verbose)
+    else:
+        # Compute and save
+        table = precompute_bfs_table(args.width, args.max_depth, verbose)
+        save_bfs_table(table, cache_path, verbose)
+    
+    if args.distances:
+        save_distance_table(table, args.width, args.max_depth,
+                            get_distance_path(args.width, args.max_depth, args.cache_dir),
+                            verbose)
     
     return 0
 
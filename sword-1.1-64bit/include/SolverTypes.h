@@ -29,6 +29,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <cassert>
 #include <stdint.h>
 #include <cstdlib>
+#include <new>
 
 namespace SWORD {
 
@@ -127,16 +128,11 @@ public:
     template<class V>
     Clause(const V& ps, bool learnt) {
         size_etc = (ps.size() << 3) | (uint32_t)learnt;
-        for (int i = 0; i < ps.size(); i++) data[i] = ps[i];
+        for (int i = 0; i < (int)ps.size(); i++) data[i] = ps[i];
         if (learnt) extra.act = 0; else calcAbstraction(); }
 
-    // -- use this function instead:
-    template<class V>
-    friend Clause* Clause_new(const V& ps, bool learnt = false) {
-        assert(sizeof(Lit)      == sizeof(uint32_t));
-        assert(sizeof(float)    == sizeof(uint32_t));
-        void* mem = std::malloc(sizeof(Clause) + sizeof(uint32_t)*(ps.size()));
-        return new (mem) Clause(ps, learnt); }
+    // -- use Clause_new() below instead, a namespace scope function so that it is
+    //    visible outside the solver
 
     int          size        ()      const   { return size_etc >> 3; }
     void         shrink      (int i)         { assert(i <= size()); size_etc = (((size_etc >> 3) - i) << 3) | (size_etc & 7); }
@@ -160,6 +156,14 @@ public:
 };
 
 
+template<class V>
+inline Clause* Clause_new(const V& ps, bool learnt = false) {
+    assert(sizeof(Lit)      == sizeof(uint32_t));
+    assert(sizeof(float)    == sizeof(uint32_t));
+    void* mem = std::malloc(sizeof(Clause) + sizeof(uint32_t)*(ps.size()));
+    return new (mem) Clause(ps, learnt); }
+
+
 /*_________________________________________________________________________________________________
 |
 |  subsumes : (other : const Clause&)  ->  Lit
@@ -201,10 +205,22 @@ inline Lit Clause::subsumes(const Clause& other) const
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  strengthen : (p : Lit)  ->  [void]
+|  
+|  Description:
+|       Removes the literal p from the clause and recomputes the abstraction. Used for
+|       subsumption resolution: if 'c.subsumes(other)' returns a literal q, then
+|       'other.strengthen(~q)' is sound. The order of the remaining literals is kept.
+|________________________________________________________________________________________________@*/
 inline void Clause::strengthen(Lit p)
 {
-    assert(false); //// compilererror
-    //remove(*this, p);
+    int j = 0;
+    while (j < size() && data[j] != p) j++;
+    assert(j < size());
+    for (; j < size()-1; j++) data[j] = data[j+1];
+    pop();
     calcAbstraction();
 }
 
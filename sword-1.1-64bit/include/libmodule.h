@@ -49,6 +49,34 @@ protected: /* module helper*/
      * reason: set of assignments that imply <code>inferedLit</code>
      *  */
     void inferLiteral(Lit inferedLit, const std::vector<Lit>& reason); 
+
+    /**
+     * like makeConflict(conflict_set_t) but takes the literals as a
+     * range [first, last), e.g. a prefix of scratchBuffer()
+     */
+    Clause* makeConflict(const Lit* first, const Lit* last);
+
+    /**
+     * like inferLiteral(Lit, const std::vector<Lit>&) but takes the
+     * reason as a range [first, last). The range is copied into 
+     * scratchBuffer(), so no memory is allocated once it has grown.
+     * The range must not point into scratchBuffer() itself.
+     */
+    void inferLiteral(Lit inferedLit, const Lit* first, const Lit* last);
+
+    /**
+     * scratch buffer for building conflicts and reasons.
+     *
+     * There is one buffer per thread, shared by all modules; it is only 
+     * valid until the next call of a module helper. Its capacity is kept 
+     * between calls, so filling it does not allocate in the steady state.
+     * The buffer cannot be a member of sword or SwordModule because their
+     * layout is fixed by lib/libsword.a; a solver calls its modules on 
+     * the thread that runs solve(), so this is one buffer per running
+     * solver. makeConflict still copies it, see above.
+     */
+    static conflict_set_t& scratchBuffer();
+
     std::vector<Lit> signalToLiterals(PSignal signal);
     void useVariables(const std::vector<Lit> & lits);
 
@@ -59,6 +87,22 @@ private: /* member variables */
 
 };
 
+inline Clause* SwordModule::makeConflict(const Lit* first, const Lit* last) {
+  // the conflict is passed by value, so this copy cannot be avoided
+  return makeConflict(conflict_set_t(first, last));
+}
+
+inline void SwordModule::inferLiteral(Lit inferedLit, const Lit* first, const Lit* last) {
+  conflict_set_t& reason = scratchBuffer();
+  reason.assign(first, last);
+  inferLiteral(inferedLit, reason);
+}
+
+inline SwordModule::conflict_set_t& SwordModule::scratchBuffer() {
+  static thread_local conflict_set_t buffer;
+  return buffer;
+}
+
 } /* namespace SWORD */
 
 #endif /* LIBMODULE__H */
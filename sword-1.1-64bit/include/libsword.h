@@ -47,7 +47,8 @@ public: /* member functions */
   PSignal addOperator(const OPCODE& o, std::vector<PSignal>* inputs); 
 
   /**
-   * extracts the signal [a, b) from a given signal [0, n)
+   * extracts the bits a down to b (inclusive, a >= b) from a given
+   * signal [0, n), like SMT-LIB extract[a:b]
    */
   PSignal addExtract(PSignal, const unsigned a, const unsigned b);
 
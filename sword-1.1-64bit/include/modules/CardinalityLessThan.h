@@ -24,13 +24,24 @@ namespace SWORD {
       }
 
       virtual Clause* propagate() {
-        conflict_set_t reason;
+        conflict_set_t& reason = scratchBuffer(); // reused, no allocation
+        reason.clear();
         for(unsigned i = 0; i< _vars.size(); ++i) {
           if( getValue(_vars[i]) == l_True )
             reason.push_back( _vars[i] );
         }
+        if ( reason.empty() && _maxOnes == 0 ) {
+          // libsword cannot handle an empty conflict; any assigned
+          // literal is a valid reason for a bound that always fails
+          for (unsigned i = 0; i < _vars.size() && reason.empty(); ++i) {
+            if ( isSet(~_vars[i]) )
+              reason.push_back( ~_vars[i] );
+          }
+          if ( reason.empty() )
+            return NULL;
+        }
         if ( reason.size() >=  _maxOnes) {
-          return makeConflict(reason);
+          return makeConflict(reason.data(), reason.data() + reason.size());
         } else { 
           return NULL;
         }
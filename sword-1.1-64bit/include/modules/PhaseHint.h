@@ -0,0 +1,53 @@
+#ifndef HEADER_PhaseHint_hpp
+#define HEADER_PhaseHint_hpp
+
+#include "../libsword.h"
+#include "../libmodule.h"
+
+#include <cassert>
+#include <vector>
+
+namespace SWORD {
+
+  /**
+   * hands a preferred assignment of a signal to the solver, like saved 
+   * phases: as long as a hinted bit is free, the module decides it to its
+   * preferred value. The hint does not constrain the search, conflicts 
+   * may flip any of the bits.
+   *
+   * <code>phases</code> has one entry per bit in the format returned by 
+   * getVariableAssignment (SWORD_TRUE, SWORD_FALSE or SWORD_DONTCARE), 
+   * e.g. the best assignment found by a local search or a heuristic.
+   */
+  class PhaseHint : public SwordModule {
+    public:
+      PhaseHint(sword * swd, PSignal signal, const std::vector<int>& phases) 
+        : SwordModule(swd)
+          , _vars(signalToLiterals(signal))
+    {
+      assert(phases.size() == _vars.size());
+      for (unsigned i = 0; i < _vars.size(); ++i) {
+        if (phases[i] == SWORD_DONTCARE)  // no preference for this bit
+          continue;
+        _hints.push_back(phases[i] == SWORD_TRUE ? _vars[i] : ~_vars[i]);
+      }
+      useVariables(_vars);
+    }
+      virtual Lit decide () {
+        for (unsigned i = 0; i < _hints.size(); ++i) {
+          if (isFree(_hints[i]))      // bit not yet assigned
+            return _hints[i];         // then take the preferred value
+        }
+        return lit_Undef;             // all hinted bits are assigned
+      }
+
+      virtual Clause* propagate() {
+        return NULL;                  // hints never cause conflicts
+      }
+      const std::vector<Lit> _vars;
+      std::vector<Lit> _hints;
+  }; // class PhaseHint
+
+} // namespace sword
+
+#endif // HEADER_PhaseHint_hpp